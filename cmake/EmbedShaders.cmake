@@ -0,0 +1,35 @@
+# Generates a header with the source of every shader, so the game does not read shaders from disk.
+# Run in script mode:
+#   cmake -DSHADER_DIR=<dir> -DOUTPUT=<header> -P EmbedShaders.cmake
+# Every .vert, .frag and .geom file of SHADER_DIR becomes a null terminated char array, listed in
+# EMBEDDED_SHADERS under its file name. Sources are written as bytes rather than string literals, so
+# no shader content can break the generated code and no compiler string length limit applies.
+
+file(GLOB SHADER_FILES RELATIVE ${SHADER_DIR} ${SHADER_DIR}/*.vert ${SHADER_DIR}/*.frag ${SHADER_DIR}/*.geom)
+list(SORT SHADER_FILES)
+
+set(CONTENT "// Generated by cmake/EmbedShaders.cmake from ${SHADER_DIR}, do not edit.\n")
+string(APPEND CONTENT "#ifndef GRAPHICS_EMBEDDEDSHADERS_H\n#define GRAPHICS_EMBEDDEDSHADERS_H\n\n")
+string(APPEND CONTENT "/// @brief The source of a shader file, compiled into the binary\n")
+string(APPEND CONTENT "struct EmbeddedShader {\n    const char *name;\n    const char *source;\n};\n\n")
+
+set(TABLE "")
+foreach(SHADER ${SHADER_FILES})
+    string(MAKE_C_IDENTIFIER "SHADER_${SHADER}" IDENTIFIER)
+    file(READ ${SHADER_DIR}/${SHADER} HEX_CONTENT HEX)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," BYTES "${HEX_CONTENT}")
+    # 16 bytes per line (CMake regular expressions have no {n} repetition)
+    set(LINE_PATTERN "")
+    foreach(I RANGE 1 16)
+        string(APPEND LINE_PATTERN "0x[0-9a-f][0-9a-f],")
+    endforeach()
+    string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n    " BYTES "${BYTES}")
+    string(APPEND CONTENT "inline constexpr char ${IDENTIFIER}[] = {\n    ${BYTES}0x00\n};\n\n")
+    string(APPEND TABLE "    {\"${SHADER}\", ${IDENTIFIER}},\n")
+endforeach()
+
+string(APPEND CONTENT "/// @brief Every embedded shader, by file name\n")
+string(APPEND CONTENT "inline constexpr EmbeddedShader EMBEDDED_SHADERS[] = {\n${TABLE}};\n\n")
+string(APPEND CONTENT "#endif //GRAPHICS_EMBEDDEDSHADERS_H\n")
+
+file(WRITE ${OUTPUT} "${CONTENT}")
@@ -0,0 +1,12 @@
+#version 330 core
+in vec2 TexCoords;
+
+out vec4 FragColor;
+
+uniform sampler2D layer;
+
+void main()
+{
+    // premultiplied color, blended with (ONE, ONE_MINUS_SRC_ALPHA)
+    FragColor = texture(layer, TexCoords);
+}
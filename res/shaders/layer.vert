@@ -0,0 +1,10 @@
+#version 330 core
+// a quad over the whole viewport, without vertex data: corners come from the vertex index
+out vec2 TexCoords;
+
+void main()
+{
+    vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+    TexCoords = corner;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,16 @@
+#version 330 core
+layout (location = 0) in vec2 aCorner;   // unit quad, shared by all particles
+layout (location = 1) in vec3 aParticle; // <vec2 center, size> per particle
+layout (location = 2) in vec4 aColor;    // per particle
+
+out vec2 Corner;
+out vec4 ParticleColor;
+
+uniform mat4 projection;
+
+void main()
+{
+    Corner = aCorner * 2.0;
+    ParticleColor = aColor;
+    gl_Position = projection * vec4(aParticle.xy + aCorner * aParticle.z, 0.0, 1.0);
+}
@@ -0,0 +1,207 @@
+#include "assetArchive.h"
+#include "../util/binaryIO.h"
+#include "../util/hash.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+using std::cout, std::endl;
+
+static const char MAGIC[4] = {'A', 'D', 'P', 'K'};
+static const uint16_t VERSION = 1;
+static const size_t HEADER_SIZE = 32;
+/// Bytes of an index entry before its name: offset, size, hash and name length.
+static const size_t INDEX_ENTRY_SIZE = 26;
+
+static uint64_t hashBytes(const void* data, size_t size) {
+    Hash hash;
+    hash.add(data, size);
+    return hash.get();
+}
+
+// --------------------------------------------------------
+// AssetArchiveWriter
+// --------------------------------------------------------
+
+bool AssetArchiveWriter::open(const string& path, uint32_t alignment) {
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0) {
+        cout << "ERROR::ASSETS: Alignment must be a power of two" << endl;
+        return false;
+    }
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        cout << "ERROR::ASSETS: Could not open " << path << " for writing" << endl;
+        return false;
+    }
+    // the header is written again by finish(), once the index is known
+    char header[HEADER_SIZE] = {};
+    out.write(header, sizeof(header));
+    this->alignment = alignment;
+    entries.clear();
+    return true;
+}
+
+bool AssetArchiveWriter::add(const string& name, const void* data, size_t size) {
+    for (const Entry& entry : entries) {
+        if (entry.name == name) {
+            cout << "ERROR::ASSETS: " << name << " was added twice" << endl;
+            return false;
+        }
+    }
+
+    // pad to the next aligned offset
+    uint64_t position = static_cast<uint64_t>(out.tellp());
+    uint64_t offset = (position + alignment - 1) & ~static_cast<uint64_t>(alignment - 1);
+    for (; position < offset; position++)
+        out.put(0);
+
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    entries.push_back({name, offset, size, hashBytes(data, size)});
+    return static_cast<bool>(out);
+}
+
+bool AssetArchiveWriter::addFile(const string& name, const string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        cout << "ERROR::ASSETS: Could not open " << path << endl;
+        return false;
+    }
+    vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (in.bad()) {
+        cout << "ERROR::ASSETS: Could not read " << path << endl;
+        return false;
+    }
+    return add(name, bytes.data(), bytes.size());
+}
+
+bool AssetArchiveWriter::finish() {
+    // sorted by name, so readers can binary search the index
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.name < b.name; });
+
+    uint64_t indexOffset = static_cast<uint64_t>(out.tellp());
+    for (const Entry& entry : entries) {
+        writeLE<uint64_t>(out, entry.offset);
+        writeLE<uint64_t>(out, entry.size);
+        writeLE<uint64_t>(out, entry.hash);
+        writeLE<uint16_t>(out, static_cast<uint16_t>(entry.name.size()));
+        out.write(entry.name.data(), static_cast<std::streamsize>(entry.name.size()));
+    }
+
+    out.seekp(0);
+    out.write(MAGIC, sizeof(MAGIC));
+    writeLE<uint16_t>(out, VERSION);
+    writeLE<uint16_t>(out, 0);
+    writeLE<uint32_t>(out, static_cast<uint32_t>(entries.size()));
+    writeLE<uint32_t>(out, alignment);
+    writeLE<uint64_t>(out, indexOffset);
+    writeLE<uint64_t>(out, 0);
+
+    bool ok = static_cast<bool>(out);
+    out.close();
+    if (!ok)
+        cout << "ERROR::ASSETS: Failed writing archive" << endl;
+    return ok;
+}
+
+// --------------------------------------------------------
+// AssetArchive
+// --------------------------------------------------------
+
+bool AssetArchive::open(const string& path) {
+    entries.clear();
+    this->path = path;
+    if (!file.open(path))
+        return false;
+
+    const uint8_t* data = file.getData();
+    size_t size = file.getSize();
+    if (size < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        cout << "ERROR::ASSETS: " << path << " is not an asset archive" << endl;
+        file.close();
+        return false;
+    }
+    if (loadLE<uint16_t>(data + 4) != VERSION) {
+        cout << "ERROR::ASSETS: Unsupported archive version " << loadLE<uint16_t>(data + 4) << endl;
+        file.close();
+        return false;
+    }
+    uint32_t entryCount = loadLE<uint32_t>(data + 8);
+    uint64_t indexOffset = loadLE<uint64_t>(data + 16);
+    if (indexOffset < HEADER_SIZE || indexOffset > size) {
+        cout << "ERROR::ASSETS: " << path << " has a corrupt header" << endl;
+        file.close();
+        return false;
+    }
+
+    if (entryCount > (size - indexOffset) / INDEX_ENTRY_SIZE) {
+        cout << "ERROR::ASSETS: " << path << " has a corrupt index" << endl;
+        file.close();
+        return false;
+    }
+
+    // read the index, checking every entry lies inside the file
+    entries.reserve(entryCount);
+    const uint8_t* position = data + indexOffset;
+    const uint8_t* end = data + size;
+    for (uint32_t i = 0; i < entryCount; i++) {
+        if (static_cast<size_t>(end - position) < INDEX_ENTRY_SIZE) break;
+        Entry entry;
+        entry.offset = loadLE<uint64_t>(position);
+        entry.size = loadLE<uint64_t>(position + 8);
+        entry.hash = loadLE<uint64_t>(position + 16);
+        uint16_t nameLength = loadLE<uint16_t>(position + 24);
+        position += INDEX_ENTRY_SIZE;
+        if (static_cast<size_t>(end - position) < nameLength || entry.offset > indexOffset ||
+            entry.size > indexOffset - entry.offset)
+            break;
+        entry.name.assign(reinterpret_cast<const char*>(position), nameLength);
+        position += nameLength;
+        entries.push_back(std::move(entry));
+    }
+    if (entries.size() != entryCount) {
+        cout << "ERROR::ASSETS: " << path << " has a corrupt index" << endl;
+        entries.clear();
+        file.close();
+        return false;
+    }
+    return true;
+}
+
+bool AssetArchive::find(const string& name, AssetView& view) {
+    auto it = std::lower_bound(entries.begin(), entries.end(), name,
+                               [](const Entry& entry, const string& key) { return entry.name < key; });
+    if (it == entries.end() || it->name != name)
+        return false;
+    if (!verify(*it))
+        return false;
+    view.data = file.getData() + it->offset;
+    view.size = static_cast<size_t>(it->size);
+    return true;
+}
+
+bool AssetArchive::verifyAll() {
+    bool intact = true;
+    for (Entry& entry : entries)
+        intact &= verify(entry);
+    return intact;
+}
+
+vector<string> AssetArchive::getNames() const {
+    vector<string> names;
+    for (const Entry& entry : entries)
+        names.push_back(entry.name);
+    return names;
+}
+
+bool AssetArchive::verify(Entry& entry) {
+    if (entry.verified)
+        return true;
+    if (hashBytes(file.getData() + entry.offset, static_cast<size_t>(entry.size)) != entry.hash) {
+        cout << "ERROR::ASSETS: " << entry.name << " in " << path << " is corrupt (hash mismatch)" << endl;
+        return false;
+    }
+    entry.verified = true;
+    return true;
+}
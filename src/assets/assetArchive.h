@@ -0,0 +1,107 @@
+#ifndef GRAPHICS_ASSETARCHIVE_H
+#define GRAPHICS_ASSETARCHIVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "../util/mappedFile.h"
+
+using std::string, std::vector;
+
+/*
+ * Asset archive layout (little endian):
+ *   header: "ADPK", u16 version, u16 reserved, u32 entryCount, u32 alignment, u64 indexOffset, u64 reserved
+ *   data:   the bytes of every asset, each starting at a multiple of alignment
+ *   index:  entryCount x { u64 offset, u64 size, u64 hash, u16 nameLength, name }, sorted by name
+ * Names are paths relative to the packed directory with '/' separators (e.g. "fonts/MxPlus_IBM_BIOS.ttf"), and
+ * hash is the 64-bit FNV-1a hash of the asset's bytes. Aligning assets to pages means an asset shares no page
+ * with another one, so reading one only faults in its own pages.
+ */
+
+/// @brief An asset inside a mapped archive; the bytes stay valid while the archive is open
+struct AssetView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+/**
+ * @brief Packs files into an asset archive
+ * @details Assets are written as they are added; the index is written by finish().
+ */
+class AssetArchiveWriter {
+public:
+    /// @brief Creates the archive file
+    /// @param alignment Boundary every asset starts at, a power of two
+    /// @return true if successful, false otherwise
+    bool open(const string& path, uint32_t alignment = 4096);
+
+    /// @brief Appends an asset
+    /// @return false if the name is already taken or writing failed
+    bool add(const string& name, const void* data, size_t size);
+
+    /// @brief Reads a file and appends it as an asset
+    /// @return false if the file could not be read or add() failed
+    bool addFile(const string& name, const string& path);
+
+    /// @brief Writes the index and header and closes the file
+    /// @return true if successful, false otherwise
+    bool finish();
+
+private:
+    struct Entry {
+        string name;
+        uint64_t offset, size, hash;
+    };
+
+    std::ofstream out;
+    uint32_t alignment = 4096;
+    vector<Entry> entries;
+};
+
+/**
+ * @brief Read-only, memory mapped asset archive
+ * @details Opening maps the file and reads the index; asset bytes are only loaded by the OS when they are first
+ * touched. An asset's content hash is checked the first time it is looked up, so a corrupt asset is reported
+ * instead of being handed to a decoder.
+ */
+class AssetArchive {
+public:
+    /// @brief Maps an archive and reads its index
+    /// @return true if successful, false otherwise
+    bool open(const string& path);
+
+    /// @brief Returns true if an archive is open
+    bool isOpen() const { return file.getData() != nullptr; }
+
+    /// @brief Looks an asset up by name
+    /// @param name The asset's name
+    /// @param view Receives the asset's bytes
+    /// @return false if there is no such asset or its bytes do not match its hash
+    bool find(const string& name, AssetView& view);
+
+    /// @brief Checks the hash of every asset (touches the whole archive)
+    /// @return true if every asset is intact, false otherwise
+    bool verifyAll();
+
+    /// @brief Returns the names of all assets, sorted
+    vector<string> getNames() const;
+
+private:
+    struct Entry {
+        string name;
+        uint64_t offset, size, hash;
+        bool verified = false;
+    };
+
+    MappedFile file;
+    string path;
+    vector<Entry> entries;
+
+    /// @brief Checks an entry's hash once
+    bool verify(Entry& entry);
+};
+
+#endif //GRAPHICS_ASSETARCHIVE_H
@@ -0,0 +1,51 @@
+#include "audioEngine.h"
+
+#include <cstdio>
+#include <iostream>
+
+using std::cout, std::endl;
+
+AudioEngine::~AudioEngine() {
+    close();
+}
+
+bool AudioEngine::open(const AudioConfig& config) {
+    close();
+    bank = std::make_unique<SampleBank>(config.sampleRate);
+    bank->generateDefaults();
+    if (!config.musicPath.empty())
+        bank->loadWav(SOUND_MUSIC, config.musicPath);
+    mixer = std::make_unique<Mixer>(*bank);
+
+    sink = createAudioSink(config.output);
+    if (sink && !sink->start(*mixer, config.bufferFrames)) {
+        sink.reset();
+        if (config.output == "device") {
+            cout << "AUDIO: Falling back to the null output" << endl;
+            sink = createAudioSink("null");
+            sink->start(*mixer, config.bufferFrames);
+        }
+    }
+    if (!sink) {
+        mixer.reset();
+        bank.reset();
+        return false;
+    }
+
+    // what is rendered but still queued in the output is not heard yet
+    uint32_t frames = sink->getBufferFrames(), buffers = sink->getBufferCount();
+    mixer->setLatency(frames * buffers);
+    char report[160];
+    std::snprintf(report, sizeof(report), "AUDIO: %s output, %u Hz, %u x %u frames (%.1f ms per buffer, %.1f ms queued)",
+                  sink->getName(), config.sampleRate, buffers, frames, 1000.0 * frames / config.sampleRate,
+                  1000.0 * frames * buffers / config.sampleRate);
+    cout << report << endl;
+    return true;
+}
+
+void AudioEngine::close() {
+    // the output stops pulling from the mixer before the mixer and samples go away
+    sink.reset();
+    mixer.reset();
+    bank.reset();
+}
@@ -0,0 +1,62 @@
+#ifndef GRAPHICS_AUDIOENGINE_H
+#define GRAPHICS_AUDIOENGINE_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "audioSink.h"
+#include "mixer.h"
+#include "sampleBank.h"
+
+using std::string, std::unique_ptr;
+
+/// @brief How audio is set up.
+struct AudioConfig {
+    /// @brief Where the audio goes: "device", "null" or "wav:<file>" (see createAudioSink())
+    string output = "device";
+
+    uint32_t sampleRate = 48000;
+
+    /// @brief Requested frames per mixer buffer; smaller is lower latency at a higher risk of dropouts
+    uint32_t bufferFrames = 256;
+
+    /// @brief Wave file played from the moment the play screen is entered (empty for none)
+    string musicPath;
+};
+
+/**
+ * @brief Owns the sample bank, the mixer and the output
+ * @details Sounds are started from the game thread through the mixer's lock-free command queue. The output's
+ * playback position, from getTime(), is meant to be the game's master clock, so the timeline the arrows are spawned
+ * and judged on advances with the music rather than beside it.
+ */
+class AudioEngine {
+public:
+    AudioEngine() = default;
+    ~AudioEngine();
+
+    /// @brief Loads the samples and starts the output
+    /// @details If the output device cannot be opened, audio falls back to the null output so the clock still runs.
+    /// @return false if no output could be started
+    bool open(const AudioConfig& config);
+
+    /// @brief Stops the output
+    void close();
+
+    /// @brief Starts a sound (game thread only)
+    void play(Sound sound, float gain = 1.0f) { mixer->play(sound, gain); }
+
+    /// @brief Stops every voice playing a sound (game thread only)
+    void stop(Sound sound) { mixer->stop(sound); }
+
+    /// @brief Returns the audible playback position in seconds
+    double getTime() const { return mixer->getTime(); }
+
+private:
+    unique_ptr<SampleBank> bank;
+    unique_ptr<Mixer> mixer;
+    unique_ptr<AudioSink> sink;
+};
+
+#endif //GRAPHICS_AUDIOENGINE_H
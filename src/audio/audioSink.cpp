@@ -0,0 +1,192 @@
+#include "audioSink.h"
+#include "../util/binaryIO.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#define MINIAUDIO_IMPLEMENTATION
+#include <miniaudio.h>
+
+using std::cout, std::endl;
+
+// --------------------------------------------------------
+// ThreadSink
+// --------------------------------------------------------
+
+ThreadSink::~ThreadSink() {
+    ThreadSink::stop();
+}
+
+bool ThreadSink::start(Mixer& mixer, uint32_t bufferFrames) {
+    ThreadSink::stop();
+    this->bufferFrames = bufferFrames;
+    bufferCount = 1;
+    running = true;
+    thread = std::thread(&ThreadSink::run, this, std::ref(mixer));
+    return true;
+}
+
+void ThreadSink::stop() {
+    if (!running)
+        return;
+    running = false;
+    thread.join();
+}
+
+void ThreadSink::run(Mixer& mixer) {
+    std::vector<float> buffer(bufferFrames * 2);
+    auto period = std::chrono::duration<double>(static_cast<double>(bufferFrames) / mixer.getSampleRate());
+    auto due = std::chrono::steady_clock::now();
+    while (running.load(std::memory_order_acquire)) {
+        mixer.render(buffer.data(), bufferFrames);
+        consume(buffer.data(), bufferFrames);
+
+        // the next buffer is due when this one would have finished playing; after a long stall, catch up
+        // to the present instead of rendering a burst
+        due += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+        auto now = std::chrono::steady_clock::now();
+        if (due < now - std::chrono::duration_cast<std::chrono::steady_clock::duration>(period * 4))
+            due = now;
+        std::this_thread::sleep_until(due);
+    }
+}
+
+// --------------------------------------------------------
+// NullSink
+// --------------------------------------------------------
+
+NullSink::~NullSink() {
+    // the thread must not call consume() once this part of the object is gone
+    ThreadSink::stop();
+}
+
+// --------------------------------------------------------
+// WavFileSink
+// --------------------------------------------------------
+
+/// Writes a 16-bit stereo wave header for the given number of frames
+static void writeWavHeader(FILE* file, uint32_t sampleRate, uint64_t frames) {
+    uint32_t dataBytes = static_cast<uint32_t>(std::min<uint64_t>(frames * 4, 0xFFFFFFFFull - 36));
+    std::ostringstream header;
+    header.write("RIFF", 4);
+    writeLE<uint32_t>(header, 36 + dataBytes);
+    header.write("WAVEfmt ", 8);
+    writeLE<uint32_t>(header, 16);
+    writeLE<uint16_t>(header, 1);              // PCM
+    writeLE<uint16_t>(header, 2);              // channels
+    writeLE<uint32_t>(header, sampleRate);
+    writeLE<uint32_t>(header, sampleRate * 4); // bytes per second
+    writeLE<uint16_t>(header, 4);              // bytes per frame
+    writeLE<uint16_t>(header, 16);             // bits per sample
+    header.write("data", 4);
+    writeLE<uint32_t>(header, dataBytes);
+    string bytes = header.str();
+    std::fseek(file, 0, SEEK_SET);
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+}
+
+WavFileSink::~WavFileSink() {
+    WavFileSink::stop();
+}
+
+bool WavFileSink::start(Mixer& mixer, uint32_t bufferFrames) {
+    stop();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        cout << "ERROR::AUDIO: Could not open " << path << " for writing" << endl;
+        return false;
+    }
+    sampleRate = mixer.getSampleRate();
+    framesWritten = 0;
+    pcm.resize(bufferFrames * 2);
+    writeWavHeader(file, sampleRate, 0);
+    return ThreadSink::start(mixer, bufferFrames);
+}
+
+void WavFileSink::stop() {
+    ThreadSink::stop();
+    if (!file)
+        return;
+    // now that the length is known, fill in the header
+    writeWavHeader(file, sampleRate, framesWritten);
+    std::fclose(file);
+    file = nullptr;
+}
+
+void WavFileSink::consume(const float* frames, uint32_t frameCount) {
+    for (uint32_t i = 0; i < frameCount * 2; i++)
+        pcm[i] = static_cast<int16_t>(std::max(-1.0f, std::min(1.0f, frames[i])) * 32767.0f);
+    std::fwrite(pcm.data(), sizeof(int16_t), frameCount * 2, file);
+    framesWritten += frameCount;
+}
+
+// --------------------------------------------------------
+// DeviceSink
+// --------------------------------------------------------
+
+struct DeviceSink::Device {
+    ma_device device;
+};
+
+/// Called by miniaudio on its real-time thread whenever the device needs more audio
+static void deviceCallback(ma_device* device, void* output, const void* /*input*/, ma_uint32 frameCount) {
+    static_cast<Mixer*>(device->pUserData)->render(static_cast<float*>(output), frameCount);
+}
+
+DeviceSink::DeviceSink() = default;
+
+DeviceSink::~DeviceSink() {
+    DeviceSink::stop();
+}
+
+bool DeviceSink::start(Mixer& mixer, uint32_t bufferFrames) {
+    DeviceSink::stop();
+    ma_device_config config = ma_device_config_init(ma_device_type_playback);
+    config.playback.format = ma_format_f32;
+    config.playback.channels = 2;
+    config.sampleRate = mixer.getSampleRate();
+    config.periodSizeInFrames = bufferFrames;
+    config.performanceProfile = ma_performance_profile_low_latency;
+    config.dataCallback = deviceCallback;
+    config.pUserData = &mixer;
+
+    auto opened = std::make_unique<Device>();
+    ma_result result = ma_device_init(nullptr, &config, &opened->device);
+    if (result != MA_SUCCESS) {
+        cout << "ERROR::AUDIO: Could not open the output device (" << ma_result_description(result) << ")" << endl;
+        return false;
+    }
+
+    // the device may not give us the sizes we asked for
+    this->bufferFrames = opened->device.playback.internalPeriodSizeInFrames;
+    bufferCount = opened->device.playback.internalPeriods;
+
+    result = ma_device_start(&opened->device);
+    if (result != MA_SUCCESS) {
+        cout << "ERROR::AUDIO: Could not start the output device (" << ma_result_description(result) << ")" << endl;
+        ma_device_uninit(&opened->device);
+        return false;
+    }
+    device = std::move(opened);
+    return true;
+}
+
+void DeviceSink::stop() {
+    if (!device)
+        return;
+    ma_device_uninit(&device->device);
+    device.reset();
+}
+
+unique_ptr<AudioSink> createAudioSink(const string& spec) {
+    if (spec == "device")
+        return std::make_unique<DeviceSink>();
+    if (spec == "null")
+        return std::make_unique<NullSink>();
+    if (spec.compare(0, 4, "wav:") == 0 && spec.size() > 4)
+        return std::make_unique<WavFileSink>(spec.substr(4));
+    cout << "ERROR::AUDIO: Unknown audio output " << spec << " (use device, null or wav:<file>)" << endl;
+    return nullptr;
+}
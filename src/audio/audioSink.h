@@ -0,0 +1,114 @@
+#ifndef GRAPHICS_AUDIOSINK_H
+#define GRAPHICS_AUDIOSINK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mixer.h"
+
+using std::string, std::unique_ptr;
+
+/**
+ * @brief Where mixed audio goes
+ * @details A sink pulls buffers from a Mixer on its own real-time thread, at the pace the output consumes them.
+ */
+class AudioSink {
+public:
+    virtual ~AudioSink() = default;
+
+    /// @brief Starts pulling audio from the mixer
+    /// @param bufferFrames Requested frames per buffer (the sink may pick a different size)
+    /// @return true if the output started, false otherwise
+    virtual bool start(Mixer& mixer, uint32_t bufferFrames) = 0;
+
+    /// @brief Stops pulling audio; the mixer is not used after this returns
+    virtual void stop() = 0;
+
+    virtual const char* getName() const = 0;
+
+    /// @brief Returns the frames per buffer and the number of buffers queued ahead of playback
+    uint32_t getBufferFrames() const { return bufferFrames; }
+    uint32_t getBufferCount() const { return bufferCount; }
+
+protected:
+    uint32_t bufferFrames = 0, bufferCount = 1;
+};
+
+/**
+ * @brief A sink with its own mixer thread that renders one buffer every buffer length, on a steady clock
+ * @details Plays the role of a sound card on machines without one, so timing behaves as it would with real output.
+ * The thread calls consume() of the derived class, so every derived class has to stop() in its own destructor;
+ * by the time ~ThreadSink() runs, the derived part is gone.
+ */
+class ThreadSink : public AudioSink {
+public:
+    ~ThreadSink() override;
+    bool start(Mixer& mixer, uint32_t bufferFrames) override;
+    void stop() override;
+
+protected:
+    /// @brief Called on the mixer thread with every rendered buffer
+    virtual void consume(const float* frames, uint32_t frameCount) = 0;
+
+private:
+    void run(Mixer& mixer);
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+};
+
+/// @brief Discards the audio (for machines without sound hardware, and headless runs).
+class NullSink : public ThreadSink {
+public:
+    ~NullSink() override;
+    const char* getName() const override { return "null"; }
+
+protected:
+    void consume(const float* /*frames*/, uint32_t /*frameCount*/) override {}
+};
+
+/// @brief Writes the audio to a 16-bit stereo wave file, in real time.
+class WavFileSink : public ThreadSink {
+public:
+    explicit WavFileSink(const string& path) : path(path) {}
+    ~WavFileSink() override;
+    bool start(Mixer& mixer, uint32_t bufferFrames) override;
+    void stop() override;
+    const char* getName() const override { return "wav file"; }
+
+protected:
+    void consume(const float* frames, uint32_t frameCount) override;
+
+private:
+    string path;
+    FILE* file = nullptr;
+    uint32_t sampleRate = 0;
+    uint64_t framesWritten = 0;
+    std::vector<int16_t> pcm;
+};
+
+/// @brief Plays the audio on the default output device (miniaudio), rendering in the device's callback.
+class DeviceSink : public AudioSink {
+public:
+    DeviceSink();
+    ~DeviceSink() override;
+    bool start(Mixer& mixer, uint32_t bufferFrames) override;
+    void stop() override;
+    const char* getName() const override { return "device"; }
+
+private:
+    /// @brief The miniaudio device, kept opaque so miniaudio.h is only included by the sink's source file
+    struct Device;
+    unique_ptr<Device> device;
+};
+
+/// @brief Creates a sink from a command line spec: "device", "null" or "wav:<file>"
+/// @return nullptr if the spec is not recognized
+unique_ptr<AudioSink> createAudioSink(const string& spec);
+
+#endif //GRAPHICS_AUDIOSINK_H
@@ -0,0 +1,83 @@
+#include "mixer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+static int64_t steadyNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Mixer::Mixer(const SampleBank& bank) : bank(bank), commands(256) {
+    renderNanos = steadyNanos();
+}
+
+void Mixer::apply(const AudioCommand& command) {
+    if (command.type == AudioCommand::STOP) {
+        for (Voice& voice : voices) {
+            if (voice.sample == &bank.get(command.sound))
+                voice.sample = nullptr;
+        }
+        return;
+    }
+
+    const Sample& sample = bank.get(command.sound);
+    if (sample.frames.empty())
+        return;
+
+    // take a free voice, or the one that has played longest
+    Voice* target = &voices[0];
+    for (Voice& voice : voices) {
+        if (!voice.sample) { target = &voice; break; }
+        if (voice.started < target->started) target = &voice;
+    }
+    target->sample = &sample;
+    target->position = 0;
+    target->gain = command.gain;
+    target->started = ++playCount;
+}
+
+void Mixer::render(float* out, uint32_t frameCount) {
+    AudioCommand command;
+    while (commands.pop(command))
+        apply(command);
+
+    std::memset(out, 0, frameCount * 2 * sizeof(float));
+    for (Voice& voice : voices) {
+        if (!voice.sample)
+            continue;
+        const float* source = voice.sample->frames.data() + voice.position * 2;
+        size_t count = std::min<size_t>(frameCount, voice.sample->getFrameCount() - voice.position);
+        for (size_t i = 0; i < count * 2; i++)
+            out[i] += source[i] * voice.gain;
+        voice.position += count;
+        if (voice.position >= voice.sample->getFrameCount())
+            voice.sample = nullptr;
+    }
+
+    // soft clip, so many voices at once saturate smoothly instead of clipping hard
+    for (uint32_t i = 0; i < frameCount * 2; i++)
+        out[i] = out[i] / (1.0f + std::abs(out[i]) * 0.25f);
+
+    framesRendered.store(framesRendered.load(std::memory_order_relaxed) + frameCount, std::memory_order_relaxed);
+    lastBufferFrames.store(frameCount, std::memory_order_relaxed);
+    renderNanos.store(steadyNanos(), std::memory_order_release);
+}
+
+double Mixer::getTime() const {
+    int64_t nanos = renderNanos.load(std::memory_order_acquire);
+    uint64_t frames = framesRendered.load(std::memory_order_relaxed);
+    double rate = bank.getSampleRate();
+
+    // the output plays on between buffers; follow it with the system clock for at most one buffer
+    double since = std::min((steadyNanos() - nanos) * 1e-9, lastBufferFrames.load(std::memory_order_relaxed) / rate);
+    double time = (static_cast<double>(frames) - latencyFrames) / rate + std::max(since, 0.0);
+
+    double last = lastTime.load(std::memory_order_relaxed);
+    if (time < last)
+        return last;
+    lastTime.store(time, std::memory_order_relaxed);
+    return time;
+}
@@ -0,0 +1,80 @@
+#ifndef GRAPHICS_MIXER_H
+#define GRAPHICS_MIXER_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "sampleBank.h"
+#include "../util/spscRing.h"
+
+/// @brief A request from the game thread to the mixer.
+struct AudioCommand {
+    enum Type : uint8_t { PLAY, STOP } type;
+    Sound sound;
+    float gain;
+};
+
+/**
+ * @brief Mixes the playing sounds into stereo float buffers on the audio thread
+ * @details The game thread talks to the mixer only through a lock-free command ring, so starting a sound never
+ * blocks it and render() never waits on the game. render() does not allocate or lock; voices are a fixed array.
+ *
+ * The mixer also is the game's clock: the number of frames rendered advances exactly as fast as the output plays
+ * them, so timing taken from getTime() stays in sync with what is heard.
+ */
+class Mixer {
+public:
+    /// @brief Most sounds playing at once; further plays steal the oldest voice
+    static const int VOICE_COUNT = 32;
+
+    /// @brief Construct a new Mixer object
+    /// @param bank The samples to play, which must outlive the mixer and not change while it renders
+    explicit Mixer(const SampleBank& bank);
+
+    /// @brief Queues a sound to start with the next rendered buffer (game thread only)
+    /// @return false if the command ring is full and the sound was dropped
+    bool play(Sound sound, float gain = 1.0f) { return commands.push({AudioCommand::PLAY, sound, gain}); }
+
+    /// @brief Queues stopping every voice playing a sound (game thread only)
+    bool stop(Sound sound) { return commands.push({AudioCommand::STOP, sound, 0.0f}); }
+
+    /// @brief Mixes the next frames (audio thread only)
+    /// @param out Receives frameCount interleaved stereo frames
+    void render(float* out, uint32_t frameCount);
+
+    /// @brief Sets how many frames rendered but not yet heard the output buffers hold, subtracted by getTime()
+    void setLatency(uint32_t frames) { latencyFrames = frames; }
+
+    /// @brief Returns the playback position in seconds (any thread)
+    /// @details Between two buffers the position is interpolated with the system clock, up to the length of the
+    ///          last buffer, so it moves smoothly while never running ahead of the audio by more than one buffer.
+    double getTime() const;
+
+    uint32_t getSampleRate() const { return bank.getSampleRate(); }
+
+private:
+    struct Voice {
+        const Sample* sample = nullptr;
+        size_t position = 0;
+        float gain = 0.0f;
+        uint64_t started = 0;
+    };
+
+    void apply(const AudioCommand& command);
+
+    const SampleBank& bank;
+    SpscRing<AudioCommand> commands;
+    Voice voices[VOICE_COUNT];
+    uint64_t playCount = 0;
+    uint32_t latencyFrames = 0;
+
+    /// @brief Frames rendered so far, the steady clock time of the last render in ns, and its length in frames.
+    /// @details Written by the audio thread after each buffer. A reader can see the three from different
+    ///          buffers; the error is below one buffer, and getTime() never goes backwards.
+    std::atomic<uint64_t> framesRendered{0};
+    std::atomic<int64_t> renderNanos{0};
+    std::atomic<uint32_t> lastBufferFrames{0};
+    mutable std::atomic<double> lastTime{0.0};
+};
+
+#endif //GRAPHICS_MIXER_H
@@ -0,0 +1,120 @@
+#include "sampleBank.h"
+#include "../util/binaryIO.h"
+#include "../util/random.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using std::cout, std::endl;
+
+static const float PI = 3.14159265f;
+
+SampleBank::SampleBank(uint32_t sampleRate) : sampleRate(sampleRate) {}
+
+/// Fills a sample with a decaying tone: a sine with a touch of its octave, and a short attack to avoid a click
+static void synthesizeTone(Sample& sample, uint32_t rate, float frequency, float seconds, float gain) {
+    size_t count = static_cast<size_t>(seconds * rate);
+    sample.frames.resize(count * 2);
+    for (size_t i = 0; i < count; i++) {
+        float t = static_cast<float>(i) / rate;
+        float envelope = std::min(1.0f, t * 500.0f) * std::exp(-t * 30.0f);
+        float value = gain * envelope * (std::sin(2 * PI * frequency * t) + 0.3f * std::sin(4 * PI * frequency * t));
+        sample.frames[2 * i] = sample.frames[2 * i + 1] = value;
+    }
+}
+
+void SampleBank::generateDefaults() {
+    // one note of a major chord per lane, so chords of presses sound like chords
+    const float frequencies[4] = {523.25f, 659.25f, 783.99f, 1046.5f};
+    for (int lane = 0; lane < 4; lane++)
+        synthesizeTone(samples[SOUND_HIT_LEFT + lane], sampleRate, frequencies[lane], 0.15f, 0.25f);
+
+    // game over: falling noisy sweep
+    Sample& over = samples[SOUND_GAME_OVER];
+    size_t count = sampleRate * 3 / 4;
+    over.frames.resize(count * 2);
+    Random noise(1);
+    float phase = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        float t = static_cast<float>(i) / sampleRate;
+        phase += 2 * PI * (220.0f - 160.0f * t) / sampleRate;
+        float value = 0.3f * std::exp(-t * 4.0f) * (std::sin(phase) + 0.2f * (noise.nextFloat() * 2 - 1));
+        over.frames[2 * i] = over.frames[2 * i + 1] = value;
+    }
+}
+
+bool SampleBank::loadWav(Sound sound, const string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char riff[4], wave[4];
+    uint32_t riffSize;
+    if (!in.read(riff, 4) || !readLE(in, riffSize) || !in.read(wave, 4) ||
+        std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(wave, "WAVE", 4) != 0) {
+        cout << "ERROR::SAMPLEBANK: " << path << " is not a wave file" << endl;
+        return false;
+    }
+
+    // walk the chunks for the format and the data
+    uint16_t format = 0, channels = 0, bits = 0;
+    uint32_t rate = 0;
+    vector<char> data;
+    char id[4];
+    uint32_t size;
+    while (in.read(id, 4) && readLE(in, size)) {
+        if (std::memcmp(id, "fmt ", 4) == 0 && size >= 16) {
+            uint32_t byteRate;
+            uint16_t blockAlign;
+            readLE(in, format); readLE(in, channels); readLE(in, rate);
+            readLE(in, byteRate); readLE(in, blockAlign); readLE(in, bits);
+            in.ignore(size - 16 + (size & 1));
+        } else if (std::memcmp(id, "data", 4) == 0) {
+            data.resize(size);
+            in.read(data.data(), size);
+            break;
+        } else {
+            in.ignore(size + (size & 1)); // chunks are padded to even sizes
+        }
+    }
+
+    bool pcm16 = format == 1 && bits == 16, float32 = format == 3 && bits == 32;
+    if (channels == 0 || rate == 0 || data.empty() || !(pcm16 || float32)) {
+        cout << "ERROR::SAMPLEBANK: " << path << " must be 16-bit PCM or 32-bit float with a data chunk" << endl;
+        return false;
+    }
+
+    // decode to stereo (mono is copied to both sides, extra channels are dropped)
+    size_t bytesPerSample = bits / 8;
+    size_t sourceFrames = data.size() / (bytesPerSample * channels);
+    vector<float> source(sourceFrames * 2);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data.data());
+    for (size_t frame = 0; frame < sourceFrames; frame++) {
+        for (int side = 0; side < 2; side++) {
+            const uint8_t* at = bytes + (frame * channels + (channels > 1 ? side : 0)) * bytesPerSample;
+            source[2 * frame + side] = pcm16 ? static_cast<int16_t>(loadLE<uint16_t>(at)) / 32768.0f
+                                             : loadLE<float>(at);
+        }
+    }
+
+    // resample linearly to the mixer's rate
+    Sample& sample = samples[sound];
+    if (rate == sampleRate) {
+        sample.frames = std::move(source);
+    } else {
+        size_t count = static_cast<size_t>(static_cast<double>(sourceFrames) * sampleRate / rate);
+        sample.frames.resize(count * 2);
+        for (size_t frame = 0; frame < count; frame++) {
+            double position = static_cast<double>(frame) * rate / sampleRate;
+            size_t i = static_cast<size_t>(position);
+            size_t next = std::min(i + 1, sourceFrames - 1);
+            float weight = static_cast<float>(position - i);
+            for (int side = 0; side < 2; side++)
+                sample.frames[2 * frame + side] =
+                        source[2 * i + side] + (source[2 * next + side] - source[2 * i + side]) * weight;
+        }
+    }
+    cout << "AUDIO: Loaded " << path << " (" << rate << " Hz, " << channels << " channels, "
+         << static_cast<float>(sample.getFrameCount()) / sampleRate << " s)" << endl;
+    return true;
+}
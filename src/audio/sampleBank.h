@@ -0,0 +1,55 @@
+#ifndef GRAPHICS_SAMPLEBANK_H
+#define GRAPHICS_SAMPLEBANK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string, std::vector;
+
+/// @brief The sounds the game plays.
+enum Sound : uint8_t {
+    SOUND_HIT_LEFT,
+    SOUND_HIT_DOWN,
+    SOUND_HIT_UP,
+    SOUND_HIT_RIGHT,
+    SOUND_GAME_OVER,
+    SOUND_MUSIC,
+    SOUND_COUNT
+};
+
+/// @brief Decoded audio, as interleaved stereo floats at the mixer's sample rate.
+struct Sample {
+    vector<float> frames;
+
+    /// @brief Returns the length in frames
+    size_t getFrameCount() const { return frames.size() / 2; }
+};
+
+/**
+ * @brief Every sound the mixer can play, decoded up front
+ * @details Samples are decoded and resampled to the mixer's rate before the mixer starts, so the audio thread only
+ * ever copies floats. The bank must not change while a mixer is using it.
+ */
+class SampleBank {
+public:
+    /// @brief Construct a new Sample Bank object
+    /// @param sampleRate The rate every sample is converted to
+    explicit SampleBank(uint32_t sampleRate = 48000);
+
+    /// @brief Synthesizes the built-in hit and game over sounds
+    void generateDefaults();
+
+    /// @brief Loads a PCM wave file (16-bit integer or 32-bit float, any channel count) into a sound slot
+    /// @return true if the file was loaded, false otherwise
+    bool loadWav(Sound sound, const string& path);
+
+    const Sample& get(Sound sound) const { return samples[sound]; }
+    uint32_t getSampleRate() const { return sampleRate; }
+
+private:
+    uint32_t sampleRate;
+    Sample samples[SOUND_COUNT];
+};
+
+#endif //GRAPHICS_SAMPLEBANK_H
@@ -1,21 +1,143 @@
 #include "engine.h"
-#include "random"
+#include <algorithm>
+#include <chrono>
 
-enum state {start, play, over};
-state screen;
+/// Bytes of each stream buffer section: all text and particles of a frame fit in one.
+const size_t STREAM_SECTION_SIZE = 2 * 1024 * 1024;
 
-// Colors
+/// Longest frame time fed to the simulation, so a stall does not queue up a burst of steps.
+const double MAX_FRAME_TIME = 0.25;
 
-int lastIntFrame;
+/// Picks a fresh seed for live sessions, replays provide their own.
+static EngineConfig withSeed(EngineConfig config) {
+    if (config.seed == 0)
+        config.seed = std::chrono::high_resolution_clock::now().time_since_epoch().count() | 1;
+    return config;
+}
 
-Engine::Engine() : keys() {
+Engine::Engine(EngineConfig config, const string& assetPath)
+    : jobs(make_unique<JobSystem>()), session(withSeed(config), SessionLayout(width, height)), keys() {
+    if (!assets.open(assetPath))
+        cout << "ASSETS: No archive at " << assetPath << ", loading loose files from ../res" << endl;
     this->initWindow();
     this->initShaders();
     this->initShapes();
+    lastFrame = glfwGetTime();
+
+}
+
+Engine::~Engine() {
+    if (latency && latency->getSampleCount() > 0)
+        latency->report("Until exit");
+    if (framePacer)
+        framePacer->report();
+    if (streamBuffer && streamBuffer->getStalls() > 0)
+        cout << "STREAM: " << streamBuffer->getStalls() << " uploads waited for the GPU" << endl;
+    if (recording) {
+        if (recording->save(recordingPath))
+            cout << "REPLAY: Saved " << recording->getTickCount() << " ticks to " << recordingPath << endl;
+    }
+}
+
+void Engine::startRecording(const string& path) {
+    recording = make_unique<Replay>();
+    recording->config = session.getConfig();
+    recordingPath = path;
+}
+
+bool Engine::startAudio(const AudioConfig& config) {
+    auto engine = make_unique<AudioEngine>();
+    if (!engine->open(config))
+        return false;
+    audio = std::move(engine);
+    // frame times now come from the audio clock
+    lastFrame = getClock();
+    return true;
+}
+
+double Engine::getClock() const {
+    return audio ? audio->getTime() : glfwGetTime();
+}
+
+bool Engine::startPublishing(const string& address) {
+    auto stream = make_unique<SpectatorPublisher>();
+    if (!stream->open(address))
+        return false;
+    publisher = std::move(stream);
+    return true;
+}
+
+bool Engine::startSpectating(const string& address) {
+    auto client = make_unique<SpectatorClient>();
+    if (!client->connect(address))
+        return false;
+    spectator = std::move(client);
+    return true;
+}
 
+bool Engine::startTelemetry(const string& path) {
+    auto writer = make_unique<TelemetryWriter>();
+    if (!writer->open(path, session.getConfig()))
+        return false;
+    telemetry = std::move(writer);
+    session.setTelemetry(telemetry.get());
+    return true;
 }
 
-Engine::~Engine() {}
+bool Engine::startDynamicResolution(const ResolutionConfig& config) {
+    dynamicResolution = make_unique<DynamicResolution>(width, height, config);
+    if (!dynamicResolution->isComplete()) {
+        dynamicResolution.reset();
+        return false;
+    }
+    cout << "RESOLUTION: Scaling the playfield down to " << config.minScale * 100 << "% to stay within "
+         << config.budgetMs << " ms of GPU time per frame" << endl;
+    return true;
+}
+
+void Engine::startFramePacing(int maxFramesInFlight) {
+    framePacer = make_unique<FramePacer>(maxFramesInFlight);
+    cout << "FRAMES: At most " << framePacer->getMaxFramesInFlight() << " frame"
+         << (framePacer->getMaxFramesInFlight() == 1 ? "" : "s") << " in flight" << endl;
+}
+
+void Engine::startLatencyMonitor() {
+    latency = make_unique<LatencyMonitor>();
+}
+
+void Engine::startParticleStress(size_t count) {
+    particleStress = count;
+    particleStressReportTime = getClock();
+    cout << "PARTICLES: Keeping " << count << " particles alive" << endl;
+}
+
+void Engine::startAutoplay(const BotConfig& config, uint64_t seed) {
+    autoplay = make_unique<Bot>(config, seed);
+}
+
+bool Engine::loadChart(const string& path) {
+    if (!session.loadChart(path))
+        return false;
+    cout << "CHART: Loaded " << path << endl;
+    return true;
+}
+
+bool Engine::startPlayback(const string& path) {
+    auto replay = make_unique<Replay>();
+    if (!replay->load(path))
+        return false;
+    if (replay->getTickCount() == 0) {
+        cout << "ERROR::REPLAY: " << path << " contains no ticks" << endl;
+        return false;
+    }
+
+    // restart the session from the recorded configuration
+    session.reset(replay->config);
+    playback = std::move(replay);
+    playbackDiverged = false;
+    cout << "REPLAY: Playing back " << playback->getTickCount() << " ticks from " << path << endl;
+    return true;
+}
 
 unsigned int Engine::initWindow(bool debug) {
     // glfw: initialize and configure
@@ -52,15 +174,33 @@ void Engine::initShaders() {
     // load shader manager
     shaderManager = make_unique<ShaderManager>();
 
-    // Load shader into shader manager and retrieve it
-    shapeShader = this->shaderManager->loadShader("../res/shaders/shape.vert", "../res/shaders/shape.frag",  nullptr, "shape");
+    // per-frame vertex data goes through one ring, sized so the largest particle upload fits a section
+    streamBuffer = make_unique<StreamBuffer>(std::max(STREAM_SECTION_SIZE, ParticleSystem::getMaxUploadSize()));
+    cout << "STREAM: " << (streamBuffer->isPersistent() ? "Persistently mapped" : "Mapping every upload of")
+         << " a " << StreamBuffer::SECTION_COUNT << " x " << STREAM_SECTION_SIZE / 1024 << " KiB ring" << endl;
+
+    // Load shader into shader manager and retrieve it (sources are embedded in the binary)
+    shapeShader = this->shaderManager->loadShader("shape.vert", "shape.frag",  nullptr, "shape");
 
     // Configure text shader and renderer
-    textShader = shaderManager->loadShader("../res/shaders/text.vert", "../res/shaders/text.frag", nullptr, "text");
-    fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), "../res/fonts/MxPlus_IBM_BIOS.ttf", 24);
+    textShader = shaderManager->loadShader("text.vert", "text.frag", nullptr, "text");
+    AssetView font;
+    if (assets.isOpen() && assets.find("fonts/MxPlus_IBM_BIOS.ttf", font))
+        fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), *streamBuffer, font.data, font.size, 24);
+    else
+        fontRenderer = make_unique<FontRenderer>(shaderManager->getShader("text"), *streamBuffer, "../res/fonts/MxPlus_IBM_BIOS.ttf", 24);
 
     // Set uniforms
     textShader.setVector2f("vertex", vec4(100, 100, .5, .5));
+
+    // Particles are cosmetic, their own seed keeps them from touching the session's random sequence
+    particleShader = shaderManager->loadShader("particle.vert", "particle.frag", nullptr, "particle");
+    particles = make_unique<ParticleSystem>(particleShader, *streamBuffer, session.getConfig().seed);
+
+    layerShader = shaderManager->loadShader("layer.vert", "layer.frag", nullptr, "layer");
+    layerShader.use();
+    layerShader.setInteger("layer", 0);
+
     shapeShader.use();
     shapeShader.setMatrix4("projection", this->PROJECTION);
 }
@@ -86,11 +226,29 @@ void Engine::initShapes() {
     arrowMarkerQ4 = make_unique<Arrow>(shapeShader, vec2{(width * 7)/8,height/6}, vec2{37.5 , 31.25}, color{1, 1, 1, 1}, 4);
     arrowBaseClickQ4 = make_unique<Arrow>(shapeShader, vec2{(width * 7)/8 - 6,height/6}, vec2{50 , 47.25}, color{0, 0, 0, 0.1}, 4);
 
+    // falling arrows of each lane are drawn with these
+    const SessionLayout& layout = session.getLayout();
+    vec2 size = {ArrowField::WIDTH, ArrowField::HEIGHT};
+    for (int lane = 0; lane < LANE_COUNT; lane++)
+        laneArrows[lane] = make_unique<Arrow>(shapeShader, vec2{layout.laneX[lane], height}, size, laneColors[lane], lane + 1);
+
+    // dividers, then click arrows so they appear under the marker arrows; only redrawn when colors change
+    playfieldLayer = make_unique<StaticLayer>(shapeShader, layerShader, width, height);
+    for (Shape* shape : {divCenter.get(), divLeft.get(), divRight.get()})
+        playfieldLayer->add(*shape);
+    for (Arrow* click : {arrowBaseClickQ1.get(), arrowBaseClickQ2.get(), arrowBaseClickQ3.get(), arrowBaseClickQ4.get()})
+        playfieldLayer->add(*click);
+    for (Arrow* marker : {arrowMarkerQ1.get(), arrowMarkerQ2.get(), arrowMarkerQ3.get(), arrowMarkerQ4.get()})
+        playfieldLayer->add(*marker);
+
 
 
 }
 
 void Engine::processInput() {
+    // input read after the wait is shown by a frame with fewer frames queued ahead of it
+    if (framePacer)
+        framePacer->waitForFrame();
     glfwPollEvents();
 
     // Set keys to true if pressed, false if released
@@ -108,59 +266,23 @@ void Engine::processInput() {
     // Mouse position saved to check for collisions
     glfwGetCursorPos(window, &MouseX, &MouseY);
 
-    // DONE: If we're in the start screen and the user presses s, change screen to play
-    if (screen == start) {
-        if (keys[GLFW_KEY_S]) {
-            screen = play;
-        }
-    }
+    // Collect the buttons the game cares about; the simulation steps apply them
+    heldButtons = 0;
+    if (keys[GLFW_KEY_LEFT])  heldButtons |= BUTTON_LEFT;
+    if (keys[GLFW_KEY_DOWN])  heldButtons |= BUTTON_DOWN;
+    if (keys[GLFW_KEY_UP])    heldButtons |= BUTTON_UP;
+    if (keys[GLFW_KEY_RIGHT]) heldButtons |= BUTTON_RIGHT;
+    if (keys[GLFW_KEY_S])     heldButtons |= BUTTON_START;
 
-    if (screen == play) {
-        arrowClickedLastFrame = false;
-        // for left (q1) turn click arrow on
-        if(keys[GLFW_KEY_LEFT]) {
-            // trigger function to check for a scored point
-            addPoint("left");
-            arrowClickedLastFrame = true;
-            arrowBaseClickQ1->setColor(blue);
-        } else {
-            arrowBaseClickQ1->setColor(vec4{0, 0, 0, 0.1});
-        }
-        // for down (q2) turn click arrow on
-        if(keys[GLFW_KEY_DOWN]){
-            // trigger function to check for a scored point
-            addPoint("down");
-            arrowClickedLastFrame = true;
-            arrowBaseClickQ2->setColor(green);
-        } else {
-            arrowBaseClickQ2->setColor(vec4{0, 0, 0, 0.1});
-        }
-        //for up (q3) turn click arrow on
-        if(keys[GLFW_KEY_UP]){
-            // trigger function to check for a scored point
-            addPoint("up");
-            arrowClickedLastFrame = true;
-            arrowBaseClickQ3->setColor(yellow);
-        } else {
-            arrowBaseClickQ3->setColor(vec4{0, 0, 0, 0.1});
-        }
-        //for right (q4) turn click arrow on
-        if(keys[GLFW_KEY_RIGHT]){
-            // trigger function to check for a scored point
-            addPoint("right");
-            arrowClickedLastFrame = true;
-            arrowBaseClickQ4->setColor(red);
-        } else {
-            arrowBaseClickQ4->setColor(vec4{0, 0, 0, 0.1});
-        }
-        // if arrow is not clicked, set all dividing lines to there original color.
-        if(!arrowClickedLastFrame){
-            color clr = {0,0,1,0.5};
-            divCenter->setColor(clr);
-            divLeft->setColor(clr);
-            divRight->setColor(clr);
-        }
-    }
+    // s on the game over screen plays again; a replay or a watched game decides its own screens
+    if ((heldButtons & ~previousButtons & BUTTON_START) && session.getScreen() == SCREEN_OVER && !playback &&
+        !spectator)
+        restart();
+
+    // only the keyboard is measured, a replay or bot presses without keys
+    if (latency && !playback && !autoplay)
+        latency->press(heldButtons & ~previousButtons & (BUTTON_LEFT | BUTTON_DOWN | BUTTON_UP | BUTTON_RIGHT), glfwGetTime());
+    previousButtons = heldButtons;
 
     // Mouse position is inverted because the origin of the window is in the top left corner
     MouseY = height - MouseY; // Invert y-axis of mouse position
@@ -171,74 +293,175 @@ void Engine::processInput() {
 
 }
 
+void Engine::restart() {
+    if (!playStart.valid)
+        return;
+    restartStart = std::chrono::steady_clock::now();
+    session.restore(playStart);
+    // the ticks before the snapshot are the same again, only the ones after it are recorded anew
+    if (recording)
+        recording->truncate(playStart.tick);
+    particles->clear();
+    accumulator = 0.0;
+    if (audio) {
+        audio->stop(SOUND_GAME_OVER);
+        audio->play(SOUND_MUSIC);
+    }
+    restartRestoreMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - restartStart).count();
+    restartPending = true;
+}
+
+void Engine::updateShapeColors(uint8_t buttons, uint8_t flash) {
+    // turn the click arrow of each held lane on
+    arrowBaseClickQ1->setColor((buttons & BUTTON_LEFT) ? blue : color{0, 0, 0, 0.1});
+    arrowBaseClickQ2->setColor((buttons & BUTTON_DOWN) ? green : color{0, 0, 0, 0.1});
+    arrowBaseClickQ3->setColor((buttons & BUTTON_UP) ? yellow : color{0, 0, 0, 0.1});
+    arrowBaseClickQ4->setColor((buttons & BUTTON_RIGHT) ? red : color{0, 0, 0, 0.1});
+
+    // add emphasis on a success click by changing div color, until the buttons are released
+    color clr = {0,0,1,0.5};
+    divLeft->setColor((flash & (1 << LANE_LEFT)) ? blue : clr);
+    divCenter->setColor((flash & (1 << LANE_UP)) ? yellow : (flash & (1 << LANE_DOWN)) ? green : clr);
+    divRight->setColor((flash & (1 << LANE_RIGHT)) ? red : clr);
+}
+
 void Engine::update() {
     // Calculate delta time
-    float currentFrame = glfwGetTime();
+    double currentFrame = getClock();
     deltaTime = currentFrame - lastFrame;
-    int c = currentFrame;
+    lastFrame = currentFrame;
+
+    updateParticles();
 
-    if(screen == play){
+    // A spectator only shows what the stream says
+    if (spectator) {
+        if (!spectator->poll())
+            glfwSetWindowShouldClose(window, true);
+        return;
+    }
 
-        // spawn an arrow every second or if the speed is fast enough spawn multiple arrows every second
-        int c = currentFrame;
-        if(currentFrame < (c + 0.25) && currentFrame > (c + 0.249) && speed < -2.5){
-            spawnArrow();
+    // Consume the elapsed time in fixed steps, the remainder carries over to the next frame
+    accumulator += std::min(deltaTime, MAX_FRAME_TIME);
+    while (accumulator >= session.getStepTime() && !shouldClose()) {
+        step();
+        accumulator -= session.getStepTime();
+    }
+}
+
+void Engine::step() {
+    // Inputs come from the replay when playing one back, or from the bot when it plays
+    uint32_t tick = session.getTick();
+    uint8_t buttons = playback ? playback->getButtons(tick) : autoplay ? autoplay->decide(session) : heldButtons;
+    if (recording)
+        recording->recordButtons(tick, buttons);
+    Screen previousScreen = session.getScreen();
+    session.step(buttons);
+    if (previousScreen == SCREEN_START && session.getScreen() == SCREEN_PLAY)
+        session.snapshot(playStart);
+
+    if (audio) {
+        // the music starts with play, so chart times line up with it
+        if (previousScreen == SCREEN_START && session.getScreen() == SCREEN_PLAY)
+            audio->play(SOUND_MUSIC);
+        if (previousScreen != SCREEN_OVER && session.getScreen() == SCREEN_OVER) {
+            audio->stop(SOUND_MUSIC);
+            audio->play(SOUND_GAME_OVER);
         }
-        if(currentFrame < (c + 0.40) && currentFrame > (c + 0.39) && speed < -3.5){
-            spawnArrow();
+        for (int lane = 0; lane < LANE_COUNT; lane++) {
+            if (session.getHitLanes() & (1 << lane))
+                audio->play(static_cast<Sound>(SOUND_HIT_LEFT + lane));
         }
-        if(currentFrame < (c + 0.90) && currentFrame > (c + 0.89) && totalScore > 150){
-            spawnArrow();
+    }
+
+    if (latency && previousScreen != SCREEN_OVER && session.getScreen() == SCREEN_OVER)
+        latency->report("Session");
+
+    const SessionLayout& layout = session.getLayout();
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        if (session.getHitLanes() & (1 << lane))
+            particles->burst({layout.laneX[lane], layout.markerY[lane]}, laneColors[lane]);
+    }
+
+    if (publisher)
+        publisher->publish(session);
+
+    uint64_t hash = session.hashState();
+    if (recording)
+        recording->recordHash(hash);
+    if (playback) {
+        if (!playbackDiverged && hash != playback->getHash(tick)) {
+            playbackDiverged = true;
+            cout << "REPLAY: Diverged at tick " << tick << " (expected " << std::hex << playback->getHash(tick)
+                 << ", got " << hash << std::dec << ")" << endl;
         }
-        if(c > lastIntFrame){
-            spawnArrow();
+        if (tick + 1 >= playback->getTickCount()) {
+            cout << "REPLAY: Finished " << playback->getTickCount() << " ticks, "
+                 << (playbackDiverged ? "diverged" : "no divergence") << endl;
+            playback.reset();
+            glfwSetWindowShouldClose(window, true);
         }
+    }
+}
 
-        // move arrow down the screen when spawned, and check if it is scored
-        for(int i = 0; i < arrows.size(); i++){
-            arrows[i]->moveY(speed);
-            // if arrow is scored, increase score counter by 5.
-            if(arrows[i]->getScored()){
-                totalScore+= 5;
-                if(speed > -4){
-                    speed-= 0.08;
-                }
-
-                if(totalScore > 500 && speed < -8){
-                    speed-= 0.01;
-                }
-                arrows.erase(arrows.begin() + i);
-            }
-                // if arrows are not scored and past the screen, it subtracts from the score.
-            else if(arrows[i]->getPosY() < 0){
-                if(!arrows[i]->getScored()){
-                    screen = over;
-                }
-                arrows.erase(arrows.begin() + i);
-            }
-        }
-        // if the total score gets to 100 user wins!
-        lastIntFrame = c;
+void Engine::updateParticles() {
+    if (particleStress == 0) {
+        particles->update(static_cast<float>(std::min(deltaTime, MAX_FRAME_TIME)), jobs.get());
+        return;
+    }
+
+    // bursts spread over the lanes, until enough particles are alive or the pools are full
+    const SessionLayout& layout = session.getLayout();
+    for (unsigned burst = 0; particles->getLiveCount() < particleStress; burst++) {
+        size_t live = particles->getLiveCount();
+        int lane = burst % LANE_COUNT;
+        particles->burst({layout.laneX[lane], layout.markerY[lane] + (burst * 37) % 400}, laneColors[lane]);
+        if (particles->getLiveCount() == live)
+            break;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    particles->update(static_cast<float>(std::min(deltaTime, MAX_FRAME_TIME)), jobs.get());
+    particleStressMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    particleStressFrames++;
+
+    if (lastFrame - particleStressReportTime >= 2.0) {
+        cout << "PARTICLES: " << particles->getLiveCount() << " alive, " << particleStressMs / particleStressFrames
+             << " ms CPU per frame (" << particles->getDropped() << " dropped so far)" << endl;
+        particleStressMs = 0.0;
+        particleStressFrames = 0;
+        particleStressReportTime = lastFrame;
     }
 }
 
 void Engine::render() {
+    frameArena.reset();
+
+    if (dynamicResolution)
+        dynamicResolution->beginFrame();
     glClearColor(0.0f, 0.0f, 0.1f, 1.0f); // Set background color to a dark blue.
     glClear(GL_COLOR_BUFFER_BIT);
 
     // Set shader to use for all shapes
     shapeShader.use();
+    // Show the watched game in viewer mode, the own session otherwise
+    const ArrowField& arrows = spectator ? spectator->getArrows() : session.getArrows();
+    Screen screen = spectator ? spectator->getScreen() : session.getScreen();
+    int totalScore = spectator ? spectator->getScore() : session.getScore();
+    if (spectator)
+        updateShapeColors(spectator->getButtons(), spectator->getFlashLanes());
+    else
+        updateShapeColors(session.getButtons(), session.getFlashLanes());
 
     // Render differently depending on screen
     int i = 0;
     switch (screen) {
         // render  start screen
-        case start: {
-            string start = "Press s to start";
-            string rules1 = "Press arrow keys to score points. If an";
-            string rules2 = "arrow is missed, its game over! as your";
-            string rules3 = "score increases so does the pace of the";
-            string rules4 = "game, so stay focused!";
+        case SCREEN_START: {
+            std::string_view start = "Press s to start";
+            std::string_view rules1 = "Press arrow keys to score points. If an";
+            std::string_view rules2 = "arrow is missed, its game over! as your";
+            std::string_view rules3 = "score increases so does the pace of the";
+            std::string_view rules4 = "game, so stay focused!";
 
             // (12 * message.length()) is the offset to center text.
             // 12 pixels is the width of each character scaled by 1.
@@ -251,49 +474,37 @@ void Engine::render() {
             break;
         }
             // render play screen
-        case play: {
-
-            // renders divders
-            divCenter->setUniforms();
-            divCenter->draw();
-            divLeft->setUniforms();
-            divLeft->draw();
-            divRight->setUniforms();
-            divRight->draw();
-
-
-            // renders click arrows first so they appear under marker arrows.
-            arrowBaseClickQ1->setUniforms();
-            arrowBaseClickQ1->draw();
-
-            arrowBaseClickQ2->setUniforms();
-            arrowBaseClickQ2->draw();
-
-            arrowBaseClickQ3->setUniforms();
-            arrowBaseClickQ3->draw();
-
-            arrowBaseClickQ4->setUniforms();
-            arrowBaseClickQ4->draw();
-
-            //render white arrows that are used to check for score.
-            arrowMarkerQ1->setUniforms();
-            arrowMarkerQ1->draw();
-            arrowMarkerQ2->setUniforms();
-            arrowMarkerQ2->draw();
-            arrowMarkerQ3->setUniforms();
-            arrowMarkerQ3->draw();
-            arrowMarkerQ4->setUniforms();
-            arrowMarkerQ4->draw();
-
-
-            // goes through arrows vector to render all spawned arrows.
-            for(int i = 0; i < arrows.size(); i++){
-                arrows[i]->setUniforms();
-                arrows[i]->draw();
+        case SCREEN_PLAY: {
+            // the playfield may be drawn at a lower resolution, the score on top of it is not
+            if (dynamicResolution)
+                dynamicResolution->beginPlayfield();
+            // the base-click arrows light up with the buttons the last step applied
+            if (latency && !spectator)
+                latency->shows(session.getButtons());
+
+            // dividers, base-click and marker arrows, from their cached texture
+            playfieldLayer->draw();
+
+            // goes through the arrow field to render all spawned arrows, between their last two simulated positions.
+            // Every arrow fell the same distance, so the speed curve gives the travel once for all of them.
+            // (a spectator shows the latest step as received)
+            double tick = session.getTick() - 1.0 + accumulator / session.getStepTime();
+            float travel = spectator ? arrows.getTravel() : session.getTravelAt(tick);
+            const float* x = arrows.getX();
+            const float* base = arrows.getBase();
+            const uint8_t* lane = arrows.getLane();
+            for(size_t i = 0; i < arrows.size(); i++){
+                Arrow& shape = *laneArrows[lane[i]];
+                shape.setPos({x[i], base[i] + travel});
+                shape.setUniforms();
+                shape.draw();
             }
+            particles->draw(PROJECTION);
+            if (dynamicResolution)
+                dynamicResolution->endPlayfield();
 
             // render current score
-            string scoreCounter = "Current score:  " + std::to_string(totalScore);
+            std::string_view scoreCounter = frameArena.format("Current score:  %d", totalScore);
             if(totalScore >= 500){
                 this->fontRenderer->renderText(scoreCounter, width/2 - (12 * scoreCounter.length()), (height/12) - 21, 1, red.vec);
             } else if( totalScore >= 250){
@@ -306,130 +517,41 @@ void Engine::render() {
 
             break;
         }
-        case over: {
+        case SCREEN_OVER: {
             // render game over screen.
             if(totalScore > 0){
-                string message = "GAME OVER! your score was: " + std::to_string(totalScore);
+                std::string_view message = frameArena.format("GAME OVER! your score was: %d", totalScore);
                 this->fontRenderer->renderText(message, width/2 - (12 * message.length()), height/2, 1, vec3{0, 1, 0});
             }
             else {
-                string message = "GAME OVER! you scored no points!";
+                std::string_view message = "GAME OVER! you scored no points!";
                 this->fontRenderer->renderText(message, width/2 - (12 * message.length()), height/2, 1, vec3{1, 0, 0});
             }
+            if (!spectator && !playback) {
+                std::string_view again = "Press s to play again";
+                this->fontRenderer->renderText(again, width/2 - (6 * again.length()), height/2 - 40, 0.50, vec3{1, 1, 1});
+            }
             break;
         }
     }
 
+    if (dynamicResolution)
+        dynamicResolution->endFrame();
     glfwSwapBuffers(window);
-}
-// adds point by checking position of arrow markers and current arrow in arrows vector
-// changes divider color when a point is scored.
-// PARAM: 'key' is used to determine which quadrant to check for a scored arrow.
-void Engine::addPoint(string key) {
-    if(key == "left") {
-        // check every arrow in arrows.
-        for (int i = 0; i < arrows.size(); i++) {
-            // if arrow is the first quad and is not scored.
-            if(arrows[i]->getRight() < divLeft->getPosX() && !(arrows[i]->getScored())) {
-                //only triggers if it is in the last 3rd of the screen
-                if(arrows[i]->getTop() < height/3) {
-                    // if an arrow is within 20 pixels above or below marker set scored to true.
-                    if(arrows[i]->getTop() < (arrowMarkerQ1->getTop() + 20) &&
-                       arrows[i]->getBottom() > (arrowMarkerQ1->getBottom() - 20)) {
-                        //add emphasis on success click by changing div color
-                        divLeft->setColor(blue);
-                        arrows[i]->setScored(true);
-                    }
-                }
-            }
-        }
-
+    streamBuffer->endFrame();
+    if (framePacer)
+        framePacer->endFrame();
+    if (latency) {
+        latency->endFrame();
+        latency->poll();
     }
-    if(key == "right"){
-        // check every arrow in arrows.
-        for (int i = 0; i < arrows.size(); i++) {
-            //in fourth quartile (right arrow) and has not been scored
-            if( arrows[i]->getRight() > divRight->getPosX() && !(arrows[i]->getScored())) {
-                //only triggers if it is in the last 3rd of the screen
-                if(arrows[i]->getTop() < height/3) {
-
-                    if(arrows[i]->getTop() < (arrowMarkerQ4->getTop() + 20) &&
-                       arrows[i]->getBottom() > (arrowMarkerQ4->getBottom() - 20)) {
-                        //add emphasis on success click by changing div color
-                        divRight->setColor(red);
-                        arrows[i]->setScored(true);
-                    }
-                }
-            }
-        }
-    }
-    if(key == "up"){
-        for (int i = 0; i < arrows.size(); i++) {
-            //in third quartile (up arrow) and has not been scored
-            if(arrows[i]->getRight() > divCenter->getPosX() && arrows[i]->getRight() < divRight->getPosX() &&
-               !(arrows[i]->getScored())) {
-                //only triggers if it is in the last 3rd of the screen
-                if(arrows[i]->getTop() < height/3) {
-                    // if an arrow is within 20 pixels above or below, marker set scored to true.
-                    if(arrows[i]->getTop() < (arrowMarkerQ3->getTop() + 20) &&
-                       arrows[i]->getBottom() > (arrowMarkerQ3->getBottom() - 20)) {
-                        //add emphasis on success click by changing div color
-                        divCenter->setColor(yellow);
-                        arrows[i]->setScored(true);
-                    }
-                }
-            }
-        }
-
-    }
-    if(key == "down"){
-        for (int i = 0; i < arrows.size(); i++) {
-            //in second quartile (down arrow) and has not been scored
-            if(arrows[i]->getRight() > divLeft->getPosX() && arrows[i]->getRight() < divCenter->getPosX() &&
-               !(arrows[i]->getScored())) {
-                //only triggers if it is in the last 3rd of the screen
-                if(arrows[i]->getTop() < height/3) {
-                    // if an arrow is within 20 pixels above or below marker set scored to true.
-                    if(arrows[i]->getTop() < (arrowMarkerQ2->getTop() + 20) &&
-                       arrows[i]->getBottom() > (arrowMarkerQ2->getBottom() - 20)) {
-                        //add emphasis on success click by changing div color
-                        divCenter->setColor(green);
-                        arrows[i]->setScored(true);
-                    }
-                }
-            }
-        }
+    if (restartPending && screen == SCREEN_PLAY) {
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - restartStart).count();
+        cout << "RESTART: Restored the session in " << restartRestoreMs << " ms, first play frame shown after " << ms
+             << " ms" << endl;
+        restartPending = false;
     }
 }
-void Engine::spawnArrow() {
-    int quartile;
-    long arrowPicked = 30;
-    vec2 pos;
-    color color;
-    vec2 size = {30, 25};
-    // adds an arrow into vector at random quadrant
-    quartile = 1 + (rand() % 4);
-
-
-    if(quartile == 1) {
-        // make an arrow with that quadrants vector
-        pos = {(width * 1) / 8, height};
-        arrows.push_back(make_unique<Arrow>(shapeShader, pos, size, blue, 1));
-    }
-    if(quartile == 2) {
-        pos = {(width * 3)/8, height};
-        arrows.push_back(make_unique<Arrow>(shapeShader, pos, size, green, 2));
-    }
-    if(quartile == 3) {
-        pos = {(width * 5)/8,height};
-        arrows.push_back(make_unique<Arrow>(shapeShader, pos, size, yellow, 3));
-    }
-    if(quartile == 4) {
-        pos = {(width * 7)/8,height};
-        arrows.push_back(make_unique<Arrow>(shapeShader, pos, size, red, 4));
-    }
-}
-
 bool Engine::shouldClose() {
     return glfwWindowShouldClose(window);
 }
@@ -1,6 +1,7 @@
 #ifndef GRAPHICS_ENGINE_H
 #define GRAPHICS_ENGINE_H
 
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <iostream>
@@ -12,6 +13,21 @@
 #include "shapes/triangle.h"
 #include "shapes/shape.h"
 #include "shapes/arrow.h"
+#include "engineConfig.h"
+#include "game/session.h"
+#include "replay/replay.h"
+#include "telemetry/telemetry.h"
+#include "audio/audioEngine.h"
+#include "net/spectator.h"
+#include "sim/bot.h"
+#include "util/frameArena.h"
+#include "assets/assetArchive.h"
+#include "render/dynamicResolution.h"
+#include "render/particleSystem.h"
+#include "render/latencyMonitor.h"
+#include "render/framePacer.h"
+#include "render/staticLayer.h"
+#include "jobs/jobSystem.h"
 
 using std::vector, std::unique_ptr, std::make_unique, glm::ortho, glm::mat4, glm::vec3, glm::vec4;
 
@@ -26,18 +42,91 @@ private:
     color yellow = color{.904, .910, 0, 1};
     color green = color{0,1,0,1};
     color white = color{1,1,1,1};
-    int totalScore = 0;
-    float speed = -1.5;
+
+    /// @brief Color of each lane's arrows and hit particles.
+    color laneColors[LANE_COUNT] = {blue, green, yellow, red};
+
+    /// @brief Frame time not yet consumed by simulation steps.
+    double accumulator = 0.0;
+
+    /// @brief Buttons held as of the last processInput(), applied by every step until the next one.
+    /// @details previousButtons are those of the processInput() before, to tell new presses.
+    uint8_t heldButtons = 0, previousButtons = 0;
+
+    /// @brief The session as of its first play step, restored to play again from the game over screen.
+    SessionSnapshot playStart;
+
+    /// @brief When the last restart began, until the first play frame after it has been shown.
+    std::chrono::steady_clock::time_point restartStart;
+    bool restartPending = false;
+    double restartRestoreMs = 0.0;
+
+    /// @brief The session being recorded, if any, and the file it is saved to on exit.
+    unique_ptr<Replay> recording;
+    string recordingPath;
+
+    /// @brief The replay being played back, if any.
+    /// @details While set, its inputs and frame times replace the keyboard and glfwGetTime().
+    unique_ptr<Replay> playback;
+    bool playbackDiverged = false;
+
+    /// @brief Writes the session's events to a log in the background, if enabled.
+    unique_ptr<TelemetryWriter> telemetry;
+
+    /// @brief Plays the music and hit sounds, and provides the clock when enabled.
+    unique_ptr<AudioEngine> audio;
+
+    /// @brief Streams every step to spectators, if enabled.
+    unique_ptr<SpectatorPublisher> publisher;
+
+    /// @brief The game being watched instead of played, in viewer mode.
+    unique_ptr<SpectatorClient> spectator;
+
+    /// @brief Plays instead of the keyboard, if enabled.
+    unique_ptr<Bot> autoplay;
+
+    /// @brief Renders the playfield at a resolution that follows the GPU load, if enabled.
+    unique_ptr<DynamicResolution> dynamicResolution;
+
+    /// @brief Keeps the driver from queuing more than a set number of frames, if enabled.
+    unique_ptr<FramePacer> framePacer;
+
+    /// @brief Measures the time from key presses until the GPU finished the frame showing them, if enabled.
+    unique_ptr<LatencyMonitor> latency;
+
+    /// @brief Worker threads that subsystems spread large loops over; the main thread helps while it waits.
+    unique_ptr<JobSystem> jobs;
+
+    /// @brief Particles kept alive by the particle stress test (0 when off), and its timing since the last report.
+    size_t particleStress = 0;
+    double particleStressMs = 0.0, particleStressReportTime = 0.0;
+    unsigned particleStressFrames = 0;
+
+    /// @brief Memory for text and other data that is only needed while drawing one frame.
+    /// @details Reset at the start of every render(), so a frame's transient data never touches the heap.
+    FrameArena frameArena{4 * 1024};
+
     /// @brief The actual GLFW window.
     GLFWwindow* window{};
 
     /// @brief The width and height of the window.
     const unsigned int width = 800, height = 600; // Window dimensions
 
+    /// @brief The game being played and drawn.
+    Session session;
+
     /// @brief Keyboard state (True if pressed, false if not pressed).
     /// @details Index this array with GLFW_KEY_{key} to get the state of a key.
     bool keys[1024];
 
+    /// @brief The packed assets (fonts), mapped at startup.
+    /// @details Declared before everything loaded from it, so the mapping outlives its users.
+    AssetArchive assets;
+
+    /// @brief Ring buffer the text quads and particle instances of every frame are streamed through.
+    /// @details Initialized in initShaders(), declared before the renderers using it.
+    unique_ptr<StreamBuffer> streamBuffer;
+
     /// @brief Responsible for loading and storing all the shaders used in the project.
     /// @details Initialized in initShaders()
     unique_ptr<ShaderManager> shaderManager;
@@ -46,12 +135,18 @@ private:
     /// @details Initialized in initShaders()
     unique_ptr<FontRenderer> fontRenderer;
 
+    /// @brief Bursts of particles on every hit, moved once per frame.
+    /// @details Initialized in initShaders()
+    unique_ptr<ParticleSystem> particles;
+
     // Shapes used in engine
     unique_ptr<Shape> divCenter;
     unique_ptr<Shape> divLeft;
     unique_ptr<Shape> divRight;
 
-    vector<unique_ptr<Arrow>> arrows;
+    /// @brief One shape per lane, moved to each arrow of that lane to draw it.
+    unique_ptr<Arrow> laneArrows[LANE_COUNT];
+
     unique_ptr<Arrow> arrow;
     unique_ptr<Rect> blinkS;
 
@@ -69,15 +164,20 @@ private:
     unique_ptr<Arrow> arrowMarkerQ4;
     unique_ptr<Arrow> arrowBaseClickQ4;
 
+    /// @brief The dividers, base-click and marker arrows, cached in a texture until one of them changes.
+    /// @details Initialized in initShapes()
+    unique_ptr<StaticLayer> playfieldLayer;
+
 
 
     // Shaders
     Shader shapeShader;
     Shader textShader;
+    Shader particleShader;
+    Shader layerShader;
 
     double MouseX, MouseY;
     bool mousePressedLastFrame = false;
-    bool arrowClickedLastFrame = false;
 
     /// @note Call glCheckError() after every OpenGL call to check for errors.
     GLenum glCheckError_(const char *file, int line);
@@ -87,7 +187,9 @@ private:
 public:
     /// @brief Constructor for the Engine class.
     /// @details Initializes window and shaders.
-    Engine();
+    /// @param config The configuration to start the session with
+    /// @param assetPath The asset archive to load fonts from (loose files under ../res are used if it is missing)
+    Engine(EngineConfig config = EngineConfig(), const string& assetPath = "assets.pak");
 
     /// @brief Destructor for the Engine class.
     ~Engine();
@@ -103,25 +205,89 @@ public:
     /// @brief Initializes the shapes to be rendered.
     void initShapes();
 
-    /// @brief Pushes back a new colored arrow to the arrows vector.
-    void spawnArrow();
-    void addPoint(string key);
+    /// @brief Records the session and saves it to path when the engine is destroyed.
+    void startRecording(const string& path);
+
+    /// @brief Loads a replay and plays it back instead of reading the keyboard.
+    /// @details Restarts the session with the configuration stored in the replay.
+    /// @return true if the replay was loaded, false otherwise
+    bool startPlayback(const string& path);
+
+    /// @brief Logs hits, misses, press timing, speed changes and the final score to a telemetry file.
+    /// @return true if the file could be created, false otherwise
+    bool startTelemetry(const string& path);
+
+    /// @brief Starts audio output and makes its playback position the clock the game runs on.
+    /// @return true if audio started, false otherwise (the game then keeps running on glfwGetTime())
+    bool startAudio(const AudioConfig& config);
+
+    /// @brief Returns the time frames are measured with: the audio position if audio runs, glfwGetTime() otherwise.
+    double getClock() const;
+
+    /// @brief Streams the session to spectators connecting to address ("tcp:<host>:<port>" or "unix:<path>").
+    /// @return true if listening, false otherwise
+    bool startPublishing(const string& address);
+
+    /// @brief Turns the engine into a viewer that shows the game streamed from address instead of playing.
+    /// @return true if connected, false otherwise
+    bool startSpectating(const string& address);
+
+    /// @brief Renders the playfield offscreen at a resolution scaled to keep the GPU frame time within a budget.
+    /// @details Text and the HUD stay at native resolution.
+    /// @return true if the offscreen target could be created, false otherwise
+    bool startDynamicResolution(const ResolutionConfig& config);
+
+    /// @brief Lets input and simulation of a frame start only once fewer than maxFramesInFlight frames are queued.
+    void startFramePacing(int maxFramesInFlight);
+
+    /// @brief Measures input-to-photon latency of the keyboard, reported when a session ends and on exit.
+    void startLatencyMonitor();
+
+    /// @brief Keeps count particles alive to measure the CPU time of the particle system, printed every 2 seconds.
+    void startParticleStress(size_t count);
+
+    /// @brief Plays the session again from its first play step, keeping the window, shaders, fonts and buffers.
+    /// @details Restores the snapshot taken when play started, so the same arrows come again. A recording is cut
+    ///          back to that tick and stays a valid replay. Prints how long it took until the first play frame.
+    void restart();
+
+    /// @brief Lets a bot play instead of reading the keyboard.
+    void startAutoplay(const BotConfig& config, uint64_t seed);
+
+    /// @brief Spawns arrows from an authored chart file instead of the random spawn scheduler.
+    /// @details The session ends once every note of the chart has been played.
+    /// @return true if the chart was loaded, false otherwise
+    bool loadChart(const string& path);
 
     /// @brief Processes input from the user.
     /// @details (e.g. keyboard input, mouse input, etc.)
+    ///          With frame pacing, first waits until the frame may start.
     void processInput();
 
+    /// @brief Colors the base-click arrows and dividers after the buttons and hits of the last step.
+    /// @param buttons Bitmask of the held Button values
+    /// @param flash Bit per lane whose divider flashes
+    void updateShapeColors(uint8_t buttons, uint8_t flash);
+
     /// @brief Updates the game state.
-    /// @details (e.g. collision detection, delta time, etc.)
+    /// @details Runs as many fixed simulation steps as the time since the last frame covers.
     void update();
 
+    /// @brief Advances the simulation by one fixed step of stepTime seconds.
+    /// @details Steps the session with the held (or replayed) buttons, plays its sounds and records or verifies its
+    ///          state hash.
+    void step();
+
+    /// @brief Moves the particles by the time of the last frame, topping them up first in the stress test.
+    void updateParticles();
+
     /// @brief Renders the game state.
     /// @details Displays/renders objects on the screen.
     void render();
 
     /* deltaTime variables */
-    float deltaTime = 0.0f; // Time between current frame and last frame
-    float lastFrame = 0.0f; // Time of last frame (used to calculate deltaTime)
+    double deltaTime = 0.0; // Time between current frame and last frame
+    double lastFrame = 0.0; // Time of last frame (used to calculate deltaTime)
 
     // -----------------------------------
     // Getters
@@ -133,6 +299,9 @@ public:
     /// @return false if the window should not close
     bool shouldClose();
 
+    /// @brief Returns the session being played.
+    const Session& getSession() const { return session; }
+
     /// Projection matrix used for 2D rendering (orthographic projection).
     /// We don't have to change this matrix since the screen size never changes.
     /// OpenGL uses the projection matrix to map the 3D scene to a 2D viewport.
@@ -0,0 +1,29 @@
+#ifndef GRAPHICS_ENGINECONFIG_H
+#define GRAPHICS_ENGINECONFIG_H
+
+#include <cmath>
+#include <cstdint>
+
+/// @brief Everything that decides how a session plays out, besides the player's input.
+/// @details Stored in the header of every replay so playback starts from the exact same state.
+struct EngineConfig {
+    /// @brief Seed of the spawn random number generator (0 picks a seed from the clock)
+    uint64_t seed = 0;
+
+    /// @brief Speed arrows fall at when the session starts
+    float startSpeed = -1.5f;
+
+    /// @brief Number of fixed simulation steps per second
+    /// @details Independent of the frame rate; higher rates lower input latency at a higher CPU cost.
+    float simRate = 240.0f;
+
+    /// @brief Highest simRate accepted; beyond it one frame would have to run thousands of steps
+    static constexpr float MAX_SIM_RATE = 10000.0f;
+
+    /// @brief Returns true if a simulation rate can drive a session (finite, positive and at most MAX_SIM_RATE)
+    /// @details A zero, negative or NaN rate makes the step time infinite, negative or NaN, so the engine would
+    ///          never step or never stop stepping.
+    static bool isValidSimRate(float rate) { return std::isfinite(rate) && rate > 0 && rate <= MAX_SIM_RATE; }
+};
+
+#endif //GRAPHICS_ENGINECONFIG_H
@@ -1,77 +1,269 @@
 #include "font.h"
 #include <glad/glad.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 
+/// @brief Spreads the bits of a codepoint over the table index
+static size_t hashCodepoint(char32_t codepoint) {
+    uint32_t h = static_cast<uint32_t>(codepoint);
+    h ^= h >> 16;
+    h *= 0x45D9F3Bu;
+    h ^= h >> 16;
+    return h;
+}
+
 Font::Font(std::string fontPath, unsigned int fontSize) {
-    FT_Library ft;
+    if (!initLibrary(fontSize))
+        return;
 
-    // Initialize FreeType library
-    if (FT_Init_FreeType(&ft)) {
-        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+    // Load font as face, it stays open to rasterize glyphs as they are needed
+    if (FT_New_Face(library, fontPath.c_str(), 0, &face)) {
+        std::cout << "ERROR::FREETYPE: Failed to load font " << fontPath << std::endl;
+        face = nullptr;
+        return;
     }
+    initAtlas(fontSize);
+}
+
+Font::Font(const unsigned char* data, size_t size, unsigned int fontSize) {
+    if (!initLibrary(fontSize))
+        return;
 
-    // Load font as face
-    FT_Face face;
-    if (FT_New_Face(ft, fontPath.c_str(), 0, &face)) {
-        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+    // Load font as face straight from memory, FreeType reads it in place
+    if (FT_New_Memory_Face(library, data, static_cast<FT_Long>(size), 0, &face)) {
+        std::cout << "ERROR::FREETYPE: Failed to load font from memory" << std::endl;
+        face = nullptr;
+        return;
     }
+    initAtlas(fontSize);
+}
+
+bool Font::initLibrary(unsigned int fontSize) {
+    std::fill(std::begin(asciiCell), std::end(asciiCell), -1);
+    missing.Advance = (fontSize / 2) << 6;
+
+    // Initialize FreeType library
+    if (FT_Init_FreeType(&library)) {
+        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
+        library = nullptr;
+        return false;
+    }
+    return true;
+}
 
+void Font::initAtlas(unsigned int fontSize) {
     // Set size to load glyphs as
     FT_Set_Pixel_Sizes(face, 0, fontSize);
 
-    // Attempt to load character glyph
-    if (FT_Load_Char(face, 'X', FT_LOAD_RENDER)) {
-        std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-    }
+    // Every cell fits a glyph of the font's line height with a pixel of empty border on each side,
+    // so linear filtering never picks up a neighbouring glyph
+    int lineHeight = static_cast<int>(face->size->metrics.height >> 6);
+    cellSize = std::max(lineHeight, static_cast<int>(fontSize)) + 2;
+    cellsPerRow = ATLAS_SIZE / cellSize;
+    int cellCount = cellsPerRow * cellsPerRow;
+
+    glyphs.resize(cellCount);
+    cellCodepoint.resize(cellCount);
+    cellBatch.resize(cellCount, 0);
+    lruPrev.resize(cellCount, -1);
+    lruNext.resize(cellCount, -1);
+    freeCells.reserve(cellCount);
+    for (int cell = cellCount; cell > 0; cell--)
+        freeCells.push_back(cell - 1);
 
+    // at most every cell holds a non-ASCII glyph, keep the table at most half full
+    size_t tableSize = 1;
+    while (tableSize < static_cast<size_t>(cellCount) * 2) tableSize <<= 1;
+    table.assign(tableSize, Slot{0, -1});
+    tableMask = tableSize - 1;
+
+    // create the empty atlas
+    pixels.assign(static_cast<size_t>(ATLAS_SIZE) * ATLAS_SIZE, 0);
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1); // disable byte-alignment restriction
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_SIZE, ATLAS_SIZE, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+
+    // set texture options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    loaded = true;
+}
 
-    // Load first 128 characters of ASCII set
-    for (unsigned char c = 0; c < 128; c++) {
-        // load character glyph 
-        if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-            continue;
+Font::~Font() {
+    if (texture)
+        glDeleteTextures(1, &texture);
+    if (face)
+        FT_Done_Face(face);
+    if (library)
+        FT_Done_FreeType(library);
+}
+
+const Character& Font::getCharacter(char32_t codepoint) {
+    if (!loaded)
+        return missing;
+
+    // ASCII: flat array, loaded glyphs stay for good
+    if (codepoint < ASCII_COUNT) {
+        int32_t cell = asciiCell[codepoint];
+        if (cell >= 0)
+            return glyphs[cell];
+        cell = acquireCell();
+        if (cell < 0)
+            return missing;
+        if (!rasterize(codepoint, cell)) {
+            freeCells.push_back(cell);
+            return codepoint == '?' ? missing : getCharacter('?');
         }
+        asciiCell[codepoint] = cell;
+        cellCodepoint[cell] = codepoint;
+        return glyphs[cell];
+    }
 
-        // generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        glTexImage2D(
-            GL_TEXTURE_2D,
-            0,
-            GL_RED,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
-            0,
-            GL_RED,
-            GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
-        );
-
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        // now store character for later use
-        Character character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            static_cast<unsigned int>(face->glyph->advance.x)
-        };
-        Characters.insert(std::pair<char, Character>(c, character));
+    // everything else: hash table and LRU order
+    size_t slot = findSlot(codepoint);
+    if (table[slot].cell >= 0) {
+        int32_t cell = table[slot].cell;
+        cellBatch[cell] = batch;
+        lruUnlink(cell);
+        lruPushFront(cell);
+        return glyphs[cell];
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
 
-    FT_Done_Face(face);
-    FT_Done_FreeType(ft);
+    if (FT_Get_Char_Index(face, codepoint) == 0)
+        return getCharacter('?');
+    int32_t cell = acquireCell();
+    if (cell < 0)
+        return missing;
+    if (!rasterize(codepoint, cell)) {
+        freeCells.push_back(cell);
+        return getCharacter('?');
+    }
+
+    // evicting may have moved entries, so look the slot up again
+    slot = findSlot(codepoint);
+    table[slot] = Slot{codepoint, cell};
+    cellCodepoint[cell] = codepoint;
+    cellBatch[cell] = batch;
+    lruPushFront(cell);
+    return glyphs[cell];
+}
+
+void Font::uploadPending() {
+    if (dirtyMinX >= dirtyMaxX)
+        return;
+
+    // one upload of the rectangle covering every changed cell
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, ATLAS_SIZE);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, dirtyMinX, dirtyMinY, dirtyMaxX - dirtyMinX, dirtyMaxY - dirtyMinY,
+                    GL_RED, GL_UNSIGNED_BYTE, &pixels[static_cast<size_t>(dirtyMinY) * ATLAS_SIZE + dirtyMinX]);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+    dirtyMinX = dirtyMinY = ATLAS_SIZE;
+    dirtyMaxX = dirtyMaxY = 0;
+}
+
+size_t Font::findSlot(char32_t codepoint) const {
+    size_t i = hashCodepoint(codepoint) & tableMask;
+    while (table[i].cell >= 0 && table[i].codepoint != codepoint)
+        i = (i + 1) & tableMask;
+    return i;
 }
 
-std::map<char, Character> Font::getCharacters() const {
-    return Characters;
+void Font::eraseSlot(char32_t codepoint) {
+    size_t i = findSlot(codepoint);
+    if (table[i].cell < 0)
+        return;
+
+    // shift later entries of the probe sequence back into the hole, so lookups never stop at it early
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & tableMask;
+        if (table[j].cell < 0)
+            break;
+        size_t home = hashCodepoint(table[j].codepoint) & tableMask;
+        bool stays = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            table[i] = table[j];
+            i = j;
+        }
+    }
+    table[i].cell = -1;
+}
+
+void Font::lruUnlink(int32_t cell) {
+    if (lruPrev[cell] >= 0) lruNext[lruPrev[cell]] = lruNext[cell];
+    else if (lruHead == cell) lruHead = lruNext[cell];
+    if (lruNext[cell] >= 0) lruPrev[lruNext[cell]] = lruPrev[cell];
+    else if (lruTail == cell) lruTail = lruPrev[cell];
+    lruPrev[cell] = lruNext[cell] = -1;
+}
+
+void Font::lruPushFront(int32_t cell) {
+    lruPrev[cell] = -1;
+    lruNext[cell] = lruHead;
+    if (lruHead >= 0) lruPrev[lruHead] = cell;
+    lruHead = cell;
+    if (lruTail < 0) lruTail = cell;
+}
+
+int32_t Font::acquireCell() {
+    if (!freeCells.empty()) {
+        int32_t cell = freeCells.back();
+        freeCells.pop_back();
+        return cell;
+    }
+
+    // the least recently used glyph makes room, unless the batch being built still needs it
+    int32_t cell = lruTail;
+    if (cell < 0 || cellBatch[cell] == batch)
+        return -1;
+    lruUnlink(cell);
+    eraseSlot(cellCodepoint[cell]);
+    evictions++;
+    return cell;
+}
+
+bool Font::rasterize(char32_t codepoint, int32_t cell) {
+    if (FT_Load_Char(face, codepoint, FT_LOAD_RENDER)) {
+        std::cout << "ERROR::FREETYTPE: Failed to load Glyph U+" << std::hex << static_cast<uint32_t>(codepoint)
+                  << std::dec << std::endl;
+        return false;
+    }
+    const FT_Bitmap& bitmap = face->glyph->bitmap;
+    int cellX = (cell % cellsPerRow) * cellSize, cellY = (cell / cellsPerRow) * cellSize;
+
+    // clear what the previous glyph of the cell left, then copy the bitmap inside the border
+    for (int row = 0; row < cellSize; row++)
+        std::memset(&pixels[static_cast<size_t>(cellY + row) * ATLAS_SIZE + cellX], 0, cellSize);
+    int width = std::min(static_cast<int>(bitmap.width), cellSize - 2);
+    int rows = std::min(static_cast<int>(bitmap.rows), cellSize - 2);
+    for (int row = 0; row < rows; row++) {
+        const unsigned char* source = bitmap.pitch >= 0 ? bitmap.buffer + row * bitmap.pitch
+                                                        : bitmap.buffer + (bitmap.rows - 1 - row) * -bitmap.pitch;
+        std::memcpy(&pixels[static_cast<size_t>(cellY + 1 + row) * ATLAS_SIZE + cellX + 1], source, width);
+    }
+
+    dirtyMinX = std::min(dirtyMinX, cellX);
+    dirtyMinY = std::min(dirtyMinY, cellY);
+    dirtyMaxX = std::max(dirtyMaxX, cellX + cellSize);
+    dirtyMaxY = std::max(dirtyMaxY, cellY + cellSize);
+
+    // now store character for later use
+    const float texel = 1.0f / ATLAS_SIZE;
+    glyphs[cell] = Character{
+        glm::vec4((cellX + 1) * texel, (cellY + 1) * texel, (cellX + 1 + width) * texel, (cellY + 1 + rows) * texel),
+        glm::ivec2(width, rows),
+        glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
+        static_cast<unsigned int>(face->glyph->advance.x)
+    };
+    return true;
 }
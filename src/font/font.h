@@ -1,8 +1,9 @@
 #ifndef GRAPHICS_FONT_H
 #define GRAPHICS_FONT_H
 
-#include <map>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 
 #include <glm/glm.hpp>
@@ -13,14 +14,14 @@
 /**
  * @brief A single character
  * @details This struct is used to store information about a single character
- * 
- * @param TextureID ID handle of the glyph texture
+ *
+ * @param TexCoords Left, top, right and bottom texture coordinates of the glyph in the font's atlas
  * @param Size Size of glyph
  * @param Bearing Offset from baseline to left/top of glyph
  * @param Advance Offset to advance to next glyph
  */
 struct Character {
-    unsigned int TextureID;
+    glm::vec4    TexCoords;
     glm::ivec2   Size;
     glm::ivec2   Bearing;
     unsigned int Advance;
@@ -28,32 +29,143 @@ struct Character {
 
 /**
  * @brief A font
- * @details This class is used to store information about a font
+ * @details Glyphs are rasterized the first time a codepoint is asked for and stored in one fixed-size atlas
+ * texture, divided into equally sized cells. When the atlas is full, the least recently used glyph gives up its
+ * cell. ASCII glyphs are looked up in a flat array and never evicted once loaded; other codepoints go through a
+ * small hash table. Rasterized glyphs are written to a copy of the atlas in memory, and uploadPending() sends
+ * everything that changed to the texture in one call, right before it is drawn.
  */
 class Font {
     public:
+        /// @brief Width and height of the atlas texture in pixels
+        static constexpr int ATLAS_SIZE = 1024;
+
+        /// @brief Number of characters with a flat array entry (the ASCII set)
+        static constexpr int ASCII_COUNT = 128;
+
         /**
          * @brief Construct a new Font object
-         * 
+         *
          * @param fontPath The path to the font file
          * @param fontSize The size of the font
          */
         Font(std::string fontPath, unsigned int fontSize);
 
-        
         /**
-         * @brief Get the characters
-         * 
-         * @return a map of characters
+         * @brief Construct a new Font object from a font file in memory
+         * @details The memory is read by FreeType whenever a glyph is rasterized, so it must outlive the font.
+         *
+         * @param data The font file's bytes
+         * @param size The size of the font file
+         * @param fontSize The size of the font
          */
-        std::map<char, Character> getCharacters() const;
+        Font(const unsigned char* data, size_t size, unsigned int fontSize);
+
+        /**
+         * @brief Destroy the Font object
+         * @details Deletes the atlas texture and closes the font file
+         */
+        ~Font();
+
+        Font(const Font&) = delete;
+        Font& operator=(const Font&) = delete;
+
+        /**
+         * @brief Get a character, rasterizing it on first use
+         * @details Codepoints the font does not have are shown as '?'. Glyphs returned since the last beginBatch()
+         * keep their cell; if every cell is taken by them, an empty glyph is returned instead.
+         *
+         * @param codepoint The Unicode codepoint
+         * @return the character, valid until the next call
+         */
+        const Character& getCharacter(char32_t codepoint);
+
+        /**
+         * @brief Starts a new batch of glyphs to be drawn together
+         * @details Glyphs used before this call may be evicted again.
+         */
+        void beginBatch() { batch++; }
+
+        /**
+         * @brief Uploads the glyphs rasterized since the last call to the atlas texture
+         */
+        void uploadPending();
+
+        /**
+         * @brief Get the atlas texture
+         */
+        unsigned int getTexture() const { return texture; }
 
-    private:
         /**
-         * @brief A set of character structs mapped to their ASCII character representations
+         * @brief Get the number of glyphs evicted from the atlas so far
          */
-        std::map<char, Character> Characters;
+        uint64_t getEvictions() const { return evictions; }
+
+    private:
+        FT_Library library = nullptr;
+        FT_Face face = nullptr;
+        bool loaded = false;
+
+        /// @brief The atlas texture and its copy in memory
+        unsigned int texture = 0;
+        std::vector<unsigned char> pixels;
+
+        /// @brief Region of the atlas changed since the last upload (empty if dirtyMinX >= dirtyMaxX)
+        int dirtyMinX = ATLAS_SIZE, dirtyMinY = ATLAS_SIZE, dirtyMaxX = 0, dirtyMaxY = 0;
+
+        /// @brief Cell size in pixels and cells per atlas row
+        int cellSize = 0, cellsPerRow = 0;
+
+        /// @brief Per cell: the glyph, its codepoint, the batch it was last used in and its LRU neighbours
+        std::vector<Character> glyphs;
+        std::vector<char32_t> cellCodepoint;
+        std::vector<uint32_t> cellBatch;
+        std::vector<int32_t> lruPrev, lruNext;
+
+        /// @brief Least and most recently used evictable cells (-1 if none)
+        int32_t lruTail = -1, lruHead = -1;
+
+        /// @brief Cells holding no glyph
+        std::vector<int32_t> freeCells;
+
+        /// @brief Cell of each loaded ASCII character, -1 if not loaded
+        int32_t asciiCell[ASCII_COUNT];
+
+        /// @brief Open addressing table from non-ASCII codepoint to cell, with linear probing
+        struct Slot {
+            char32_t codepoint;
+            int32_t cell; // -1 if the slot is empty
+        };
+        std::vector<Slot> table;
+        size_t tableMask = 0;
+
+        /// @brief Returned when a glyph cannot be loaded
+        Character missing{};
+
+        uint32_t batch = 1;
+        uint64_t evictions = 0;
+
+        /// @brief Initializes FreeType, returns false if it failed
+        bool initLibrary(unsigned int fontSize);
+
+        /// @brief Sizes the opened face and creates the atlas
+        void initAtlas(unsigned int fontSize);
+
+        /// @brief Returns the table slot of codepoint, or of the empty slot it would go to
+        size_t findSlot(char32_t codepoint) const;
+
+        /// @brief Removes codepoint from the table, keeping probe sequences intact
+        void eraseSlot(char32_t codepoint);
+
+        void lruUnlink(int32_t cell);
+        void lruPushFront(int32_t cell);
+
+        /// @brief Returns a cell for a new glyph, evicting the least recently used one if needed, or -1
+        int32_t acquireCell();
 
+        /// @brief Rasterizes codepoint into cell
+        /// @return false if the font has no glyph for codepoint
+        bool rasterize(char32_t codepoint, int32_t cell);
 };
 
 #endif //GRAPHICS_FONT_H
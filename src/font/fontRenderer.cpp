@@ -1,74 +1,99 @@
 #include "fontRenderer.h"
+#include "../util/utf8.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
-FontRenderer::FontRenderer(Shader& shader, std::string fontPath, int fontSize) {
+#include <algorithm>
+
+FontRenderer::FontRenderer(Shader& shader, StreamBuffer& stream, std::string fontPath, int fontSize)
+    : FontRenderer(shader, stream, std::make_unique<Font>(fontPath, fontSize)) {}
+
+FontRenderer::FontRenderer(Shader& shader, StreamBuffer& stream, const unsigned char* data, size_t size, int fontSize)
+    : FontRenderer(shader, stream, std::make_unique<Font>(data, size, fontSize)) {}
+
+FontRenderer::FontRenderer(Shader& shader, StreamBuffer& stream, std::unique_ptr<Font> font) : stream(stream) {
     this->shader = shader;
     this->initRenderData();
-    Font myFont(fontPath, fontSize);
-    this->font = myFont.getCharacters();
+    this->font = std::move(font);
+    this->projectionLocation = glGetUniformLocation(this->shader.ID, "projection");
+    this->colorLocation = glGetUniformLocation(this->shader.ID, "textColor");
 }
 
 FontRenderer::~FontRenderer() {
     glDeleteVertexArrays(1, &this->VAO);
-    glDeleteBuffers(1, &this->VBO);
 }
 
 void FontRenderer::initRenderData() {
+    // the attribute is pointed at each batch's place in the stream buffer when it is drawn
     glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
     glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
-void FontRenderer::renderText(std::string text, float x, float y, float scale, glm::vec3 color) {
+void FontRenderer::renderText(std::string_view text, float x, float y, float scale, glm::vec3 color) {
     // activate corresponding render state
 
     this->shader.use();
-    glUniformMatrix4fv(glGetUniformLocation(this->shader.ID, "projection"), 1, false, glm::value_ptr(projection));
-    glUniform3f(glGetUniformLocation(this->shader.ID, "textColor"), color.x, color.y, color.z);
+    glUniformMatrix4fv(this->projectionLocation, 1, false, glm::value_ptr(projection));
+    glUniform3f(this->colorLocation, color.x, color.y, color.z);
 
     glActiveTexture(GL_TEXTURE0);
     glBindVertexArray(this->VAO);
 
-    // iterate through all characters
-    std::string::const_iterator c;
-    for (c = text.begin(); c != text.end(); c++) {
-        Character ch = font[*c];
+    // iterate through all characters, collecting their quads
+    int glyphCount = 0;
+    font->beginBatch();
+    size_t position = 0;
+    while (position < text.size()) {
+        Character ch = font->getCharacter(decodeUtf8(text, position));
 
         float xpos = x + ch.Bearing.x * scale;
         float ypos = y - (ch.Size.y - ch.Bearing.y) * scale;
 
         float w = ch.Size.x * scale;
         float h = ch.Size.y * scale;
-        // update VBO for each character
-        float vertices[6][4] = {
-            { xpos,     ypos + h,   0.0f, 0.0f },            
-            { xpos,     ypos,       0.0f, 1.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-
-            { xpos,     ypos + h,   0.0f, 0.0f },
-            { xpos + w, ypos,       1.0f, 1.0f },
-            { xpos + w, ypos + h,   1.0f, 0.0f }           
+        float u0 = ch.TexCoords.x, v0 = ch.TexCoords.y, u1 = ch.TexCoords.z, v1 = ch.TexCoords.w;
+        float quad[6][4] = {
+            { xpos,     ypos + h,   u0, v0 },
+            { xpos,     ypos,       u0, v1 },
+            { xpos + w, ypos,       u1, v1 },
+
+            { xpos,     ypos + h,   u0, v0 },
+            { xpos + w, ypos,       u1, v1 },
+            { xpos + w, ypos + h,   u1, v0 }
         };
-        // render glyph texture over quad
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-        // update content of VBO memory
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices); 
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        // render quad
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        std::copy(&quad[0][0], &quad[0][0] + 24, &vertices[glyphCount * 24]);
+
+        // draw once the batch is full, glyphs of the next batch may then replace the ones just drawn
+        if (++glyphCount == BATCH_GLYPHS) {
+            drawBatch(glyphCount);
+            glyphCount = 0;
+            font->beginBatch();
+        }
         // now advance cursors for next glyph (note that advance is number of 1/64 pixels)
         x += (ch.Advance >> 6) * scale; // bitshift by 6 to get value in pixels (2^6 = 64)
     }
+    if (glyphCount > 0)
+        drawBatch(glyphCount);
 
     glBindVertexArray(0);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
+
+void FontRenderer::drawBatch(int glyphCount) {
+    // glyphs rasterized for this batch go to the atlas before it is sampled
+    font->uploadPending();
+    glBindTexture(GL_TEXTURE_2D, font->getTexture());
+
+    // stream the quads, the ring never makes this wait for earlier draws
+    GLintptr offset = stream.upload(vertices, sizeof(float) * 24 * glyphCount, 4 * sizeof(float));
+    if (offset < 0)
+        return;
+    glBindBuffer(GL_ARRAY_BUFFER, stream.getBuffer());
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)offset);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    // render quads
+    glDrawArrays(GL_TRIANGLES, 0, 6 * glyphCount);
+}
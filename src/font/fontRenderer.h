@@ -4,6 +4,10 @@
 #include "../shader/shaderManager.h"
 #include "../shader/shader.h"
 #include "font.h"
+#include "../render/streamBuffer.h"
+
+#include <memory>
+#include <string_view>
 
 /**
  * @brief A font renderer
@@ -14,40 +18,72 @@ class FontRenderer {
         /**
          * @brief Construct a new Font Renderer object
          * @details This constructor will call the font constructor and initialize the render data
-         * 
+         *
          * @param shader The shader to use
+         * @param stream The buffer the quads are streamed through, must outlive the renderer
          * @param fontPath The path to the font file
          * @param fontSize The size of the font
          */
-        FontRenderer(Shader& shader, std::string fontPath, int fontSize);
+        FontRenderer(Shader& shader, StreamBuffer& stream, std::string fontPath, int fontSize);
+
+        /**
+         * @brief Construct a new Font Renderer object from a font file in memory (e.g. in an asset archive)
+         *
+         * @param shader The shader to use
+         * @param stream The buffer the quads are streamed through, must outlive the renderer
+         * @param data The font file's bytes, must outlive the renderer
+         * @param size The size of the font file
+         * @param fontSize The size of the font
+         */
+        FontRenderer(Shader& shader, StreamBuffer& stream, const unsigned char* data, size_t size, int fontSize);
 
         /**
          * @brief Destroy the Font Renderer object
-         * @details destroys the VAO and VBO associated with the font renderer
+         * @details destroys the VAO associated with the font renderer
          */
         ~FontRenderer();
 
         /**
          * @brief Renders text on the screen
-         * 
+         * @details The text is UTF-8; all its glyphs come from the font's atlas, so it is drawn with one draw call
+         * per BATCH_GLYPHS characters. Does not allocate; the text only has to stay valid during the call.
+         *
          * @param text The text to render
          * @param x The x position of the text
          * @param y The y position of the text
          * @param scale The scale of the text
          * @param color The color of the text
          */
-        void renderText(std::string text, float x, float y, float scale, glm::vec3 color);
+        void renderText(std::string_view text, float x, float y, float scale, glm::vec3 color);
+
+        /**
+         * @brief Get the font
+         */
+        Font& getFont() { return *font; }
 
     private:
+        /// @brief Characters drawn per draw call
+        static constexpr int BATCH_GLYPHS = 128;
+
         /**
          * @brief The shader to use
          */
         Shader shader;
 
         /**
-         * @brief The VAO and VBO associated with the font renderer
+         * @brief The VAO associated with the font renderer, its vertices come from the stream buffer
+         */
+        GLuint VAO;
+
+        /**
+         * @brief The buffer every batch's quads are uploaded to
          */
-        GLuint VAO, VBO;
+        StreamBuffer& stream;
+
+        /**
+         * @brief Locations of the projection and textColor uniforms, looked up once
+         */
+        GLint projectionLocation, colorLocation;
 
         /**
          * @brief The projection matrix
@@ -55,15 +91,29 @@ class FontRenderer {
         glm::mat4 projection = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f); // TODO: decide if this should be here or constant in engine class
 
         /**
-         * @brief A set of character structs mapped to their ASCII character representations
-         * @details This is the same map generated by the font class
+         * @brief The glyph cache of the font
+         */
+        std::unique_ptr<Font> font;
+
+        /**
+         * @brief Quads of the batch being built, 6 vertices of <vec2 pos, vec2 tex> per character
          */
-        std::map<char, Character> font;
+        float vertices[BATCH_GLYPHS * 6 * 4];
+
+        /**
+         * @brief Construct a new Font Renderer object for an opened font
+         */
+        FontRenderer(Shader& shader, StreamBuffer& stream, std::unique_ptr<Font> font);
 
         /**
          * @brief Initializes and configures the buffer and vertex attributes
          */
         void initRenderData();
+
+        /**
+         * @brief Uploads the pending glyphs and the first glyphCount quads and draws them
+         */
+        void drawBatch(int glyphCount);
 };
 
 #endif // FONTRENDERER_H
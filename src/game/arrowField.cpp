@@ -0,0 +1,100 @@
+#include "arrowField.h"
+
+ArrowField::ArrowField(size_t capacity) {
+    grow(capacity > 0 ? capacity : 1);
+}
+
+void ArrowField::grow(size_t newCapacity) {
+    size_t oldCapacity = x.size();
+    x.resize(newCapacity);
+    base.resize(newCapacity);
+    spawnTime.resize(newCapacity);
+    lane.resize(newCapacity);
+    state.resize(newCapacity);
+    slotOf.resize(newCapacity);
+    indexOfSlot.resize(newCapacity);
+    generation.resize(newCapacity, 0);
+
+    // new slots are handed out lowest first
+    freeSlots.reserve(newCapacity);
+    for (size_t slot = newCapacity; slot > oldCapacity; slot--)
+        freeSlots.push_back(static_cast<uint32_t>(slot - 1));
+}
+
+ArrowHandle ArrowField::spawn(float px, float py, uint8_t arrowLane, float time) {
+    if (freeSlots.empty())
+        grow(x.size() * 2);
+
+    uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    size_t i = count++;
+    x[i] = px;
+    base[i] = py - travel;
+    spawnTime[i] = time;
+    lane[i] = arrowLane;
+    state[i] = LIVE;
+    slotOf[i] = slot;
+    indexOfSlot[slot] = static_cast<uint32_t>(i);
+    return {slot, generation[slot]};
+}
+
+void ArrowField::remove(size_t index) {
+    uint32_t slot = slotOf[index];
+    generation[slot]++;
+    freeSlots.push_back(slot);
+
+    // move the last arrow into the hole
+    size_t last = --count;
+    if (index != last) {
+        x[index] = x[last];
+        base[index] = base[last];
+        spawnTime[index] = spawnTime[last];
+        lane[index] = lane[last];
+        state[index] = state[last];
+        slotOf[index] = slotOf[last];
+        indexOfSlot[slotOf[index]] = static_cast<uint32_t>(index);
+    }
+}
+
+void ArrowField::clear() {
+    while (count > 0)
+        remove(count - 1);
+    distance = origin = 0.0;
+    travel = prevTravel = 0.0f;
+}
+
+void ArrowField::moveTo(double to) {
+    distance = to;
+    prevTravel = travel;
+    travel = travelAt(distance);
+    while (travel <= -REBASE_DISTANCE || travel >= REBASE_DISTANCE) {
+        // y = base + travel stays the same; a power of two keeps the shift itself from rounding in most cases
+        float shift = travel < 0 ? -REBASE_DISTANCE : REBASE_DISTANCE;
+        for (size_t i = 0; i < count; i++)
+            base[i] += shift;
+        origin += shift;
+        travel = travelAt(distance);
+        prevTravel -= shift;
+    }
+}
+
+void ArrowField::setDistance(double newOrigin, double to) {
+    origin = newOrigin;
+    distance = to;
+    travel = prevTravel = travelAt(distance);
+}
+
+bool ArrowField::isValid(ArrowHandle handle) const {
+    return handle.slot < generation.size() && generation[handle.slot] == handle.generation &&
+           indexOfSlot[handle.slot] < count && slotOf[indexOfSlot[handle.slot]] == handle.slot;
+}
+
+size_t ArrowField::indexOf(ArrowHandle handle) const {
+    return indexOfSlot[handle.slot];
+}
+
+ArrowHandle ArrowField::handleAt(size_t index) const {
+    uint32_t slot = slotOf[index];
+    return {slot, generation[slot]};
+}
@@ -0,0 +1,146 @@
+#ifndef GRAPHICS_ARROWFIELD_H
+#define GRAPHICS_ARROWFIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+/// @brief Handle to an arrow in an ArrowField.
+/// @details Stays valid until that arrow is removed; a handle to a removed arrow never matches a newer arrow
+///          reusing its slot, because the slot's generation is bumped on removal.
+struct ArrowHandle {
+    uint32_t slot;
+    uint32_t generation;
+};
+
+/**
+ * @brief All falling arrows, stored as a structure of arrays
+ * @details Each attribute lives in its own contiguous array so per-arrow loops touch only the data they need.
+ * Arrows are addressed by dense index (0 to size() - 1) for iteration, and by ArrowHandle when a reference has to
+ * survive removals. Removing swaps the last arrow into the hole, so removal is O(1) but does not keep order.
+ * Memory is reserved up front; spawning never allocates until the capacity is exceeded.
+ *
+ * All arrows fall at the same speed, so positions are not stored: each arrow keeps its base, the y it has when the
+ * field has fallen to its origin, and the field the distance everything has fallen, as the session's SpeedCurve
+ * gives it for the current tick. An arrow's y is base + travel, where the travel is the distance past the origin,
+ * evaluated when read, and moving all arrows is setting one distance. To keep bases precise in long sessions, the
+ * origin follows the distance in steps of REBASE_DISTANCE pixels, shifting every base by the same power of two.
+ */
+class ArrowField {
+public:
+    /// @brief Arrow states
+    enum State : uint8_t {
+        LIVE = 0,
+        SCORED = 1
+    };
+
+    /// @brief Width and height of every arrow
+    static constexpr float WIDTH = 30.0f, HEIGHT = 25.0f;
+
+    /// @brief Travel at which bases are shifted back towards 0
+    static constexpr float REBASE_DISTANCE = 4096.0f;
+
+    /// @brief Construct a new Arrow Field object
+    /// @param capacity Number of arrows to reserve memory for
+    explicit ArrowField(size_t capacity = 1024);
+
+    /// @brief Adds a live arrow
+    /// @param x The x position of the arrow's center
+    /// @param y The y position of the arrow's center
+    /// @param lane The lane the arrow falls in (0 = left, 1 = down, 2 = up, 3 = right)
+    /// @param spawnTime Simulation time the arrow was spawned at
+    /// @return A handle to the new arrow
+    ArrowHandle spawn(float x, float y, uint8_t lane, float spawnTime);
+
+    /// @brief Removes the arrow at a dense index by moving the last arrow into its place
+    void remove(size_t index);
+
+    /// @brief Removes all arrows and invalidates all handles, the distance and origin restart at 0
+    void clear();
+
+    /// @brief Moves every arrow to a distance fallen (negative is down), in O(1) except once every REBASE_DISTANCE
+    ///        pixels
+    void moveTo(double distance);
+
+    /// @brief Sets the origin and the distance fallen, before and after the last moveTo(), to a mirrored field's
+    void setDistance(double origin, double distance);
+
+    /// @brief Returns the distance all arrows have fallen, and the distance the bases are measured from
+    double getDistance() const { return distance; }
+    double getOrigin() const { return origin; }
+
+    /// @brief Returns the travel (distance past the origin) after and before the last moveTo()
+    float getTravel() const { return travel; }
+    float getPrevTravel() const { return prevTravel; }
+
+    /// @brief Returns the travel of a distance fallen, which added to a base gives that arrow's y at that distance
+    float travelAt(double at) const { return static_cast<float>(at - origin); }
+
+    /// @brief Returns true if the handle still refers to a live arrow
+    bool isValid(ArrowHandle handle) const;
+
+    /// @brief Returns the current dense index of a valid handle
+    size_t indexOf(ArrowHandle handle) const;
+
+    /// @brief Returns the handle of the arrow at a dense index
+    ArrowHandle handleAt(size_t index) const;
+
+    /// @brief Returns the number of arrows
+    size_t size() const { return count; }
+
+    /// @brief Returns the number of arrows that fit before the arrays have to grow
+    size_t capacity() const { return x.size(); }
+
+    // --------------------------------------------------------
+    // Attribute arrays, indexed by dense index
+    // --------------------------------------------------------
+    float* getX()                   { return x.data(); }
+    float* getBase()                { return base.data(); }
+    uint8_t* getLane()              { return lane.data(); }
+    uint8_t* getState()             { return state.data(); }
+    float* getSpawnTime()           { return spawnTime.data(); }
+    const float* getX() const       { return x.data(); }
+    const float* getBase() const    { return base.data(); }
+    const uint8_t* getLane() const  { return lane.data(); }
+    const uint8_t* getState() const { return state.data(); }
+    const float* getSpawnTime() const { return spawnTime.data(); }
+
+    /// @brief Returns the y of the arrow at a dense index, now and before the last moveTo()
+    float getY(size_t i) const      { return base[i] + travel; }
+    float getPrevY(size_t i) const  { return base[i] + prevTravel; }
+
+    // Bounds of the arrow at a dense index
+    float getLeft(size_t i) const   { return x[i] - WIDTH / 2; }
+    float getRight(size_t i) const  { return x[i] + WIDTH / 2; }
+    float getTop(size_t i) const    { return getY(i) + HEIGHT / 2; }
+    float getBottom(size_t i) const { return getY(i) - HEIGHT / 2; }
+
+private:
+    size_t count = 0;
+
+    /// @brief Distance every arrow has fallen (negative is down), and the distance the bases are measured from
+    double distance = 0.0, origin = 0.0;
+
+    /// @brief distance - origin, after and before the last moveTo()
+    float travel = 0.0f, prevTravel = 0.0f;
+
+    /// @brief Per arrow attributes, the first count entries are in use
+    vector<float> x, base, spawnTime;
+    vector<uint8_t> lane, state;
+
+    /// @brief Slot of the arrow at each dense index
+    vector<uint32_t> slotOf;
+
+    /// @brief Dense index and generation of each slot
+    vector<uint32_t> indexOfSlot, generation;
+
+    /// @brief Slots not used by any arrow
+    vector<uint32_t> freeSlots;
+
+    /// @brief Grows every array so it can hold newCapacity arrows
+    void grow(size_t newCapacity);
+};
+
+#endif //GRAPHICS_ARROWFIELD_H
@@ -0,0 +1,212 @@
+#include "arrowKernels.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define ARROW_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define ARROW_TARGET_AVX2
+#else
+#define ARROW_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+// Scalar version, also handles the tail the vector versions leave over.
+static size_t checkArrowsScalar(const ArrowField& field, const ArrowCheckParams& params, uint8_t* flags,
+                                size_t begin, size_t end) {
+    const float* base = field.getBase();
+    float travel = field.getTravel(), prevTravel = field.getPrevTravel();
+    const uint8_t* lane = field.getLane();
+    const uint8_t* state = field.getState();
+
+    size_t flagged = 0;
+    for (size_t i = begin; i < end; i++) {
+        float low = params.hitLow[lane[i]];
+        float oldY = base[i] + prevTravel;
+        float newY = base[i] + travel;
+
+        bool missed = state[i] == ArrowField::LIVE && low < oldY && newY <= low;
+        bool expired = newY < 0;
+        flags[i] = (missed ? ARROW_MISSED : 0) | (expired ? ARROW_EXPIRED : 0);
+        flagged += flags[i] != 0;
+    }
+    return flagged;
+}
+
+static size_t runScalar(const ArrowField& field, const ArrowCheckParams& params, uint8_t* flags) {
+    return checkArrowsScalar(field, params, flags, 0, field.size());
+}
+
+#ifdef ARROW_KERNELS_X86
+
+// Number of set bits of each 4-bit value, to count movemask results without branches.
+static const uint8_t BIT_COUNT[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+
+// Loads 4 bytes and zero extends them to 4 32-bit lanes.
+static inline __m128i loadBytes4(const uint8_t* p) {
+    int32_t bits;
+    std::memcpy(&bits, p, sizeof(bits));
+    __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bits), zero), zero);
+}
+
+// Per 32-bit lane, returns a where mask is set and b elsewhere.
+static inline __m128 blend(__m128 mask, __m128 a, __m128 b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static size_t runSSE2(const ArrowField& field, const ArrowCheckParams& params, uint8_t* flags) {
+    const float* base = field.getBase();
+    const uint8_t* lane = field.getLane();
+    const uint8_t* state = field.getState();
+    size_t count = field.size();
+
+    const __m128 low0 = _mm_set1_ps(params.hitLow[0]), low1 = _mm_set1_ps(params.hitLow[1]);
+    const __m128 low2 = _mm_set1_ps(params.hitLow[2]), low3 = _mm_set1_ps(params.hitLow[3]);
+    const __m128i one = _mm_set1_epi32(1), two = _mm_set1_epi32(2), three = _mm_set1_epi32(3);
+    const __m128 travel = _mm_set1_ps(field.getTravel()), prevTravel = _mm_set1_ps(field.getPrevTravel());
+    const __m128 zero = _mm_setzero_ps();
+    const __m128i liveState = _mm_set1_epi32(ArrowField::LIVE);
+    const __m128i missedBit = _mm_set1_epi32(ARROW_MISSED);
+    const __m128i expiredBit = _mm_set1_epi32(ARROW_EXPIRED);
+
+    size_t flagged = 0, i = 0;
+    for (; i + 4 <= count; i += 4) {
+        // pick each arrow's hitLow by its lane
+        __m128i lanes = loadBytes4(lane + i);
+        __m128 low = blend(_mm_castsi128_ps(_mm_cmpeq_epi32(lanes, three)), low3,
+                     blend(_mm_castsi128_ps(_mm_cmpeq_epi32(lanes, two)), low2,
+                     blend(_mm_castsi128_ps(_mm_cmpeq_epi32(lanes, one)), low1, low0)));
+        __m128i live = _mm_cmpeq_epi32(loadBytes4(state + i), liveState);
+
+        __m128 arrowBase = _mm_loadu_ps(base + i);
+        __m128 oldY = _mm_add_ps(arrowBase, prevTravel);
+        __m128 newY = _mm_add_ps(arrowBase, travel);
+
+        __m128i passedLow = _mm_castps_si128(_mm_and_ps(_mm_cmplt_ps(low, oldY), _mm_cmple_ps(newY, low)));
+        __m128i missed = _mm_and_si128(live, passedLow);
+        __m128i expired = _mm_castps_si128(_mm_cmplt_ps(newY, zero));
+
+        __m128i bits = _mm_or_si128(_mm_and_si128(missed, missedBit), _mm_and_si128(expired, expiredBit));
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(bits, bits), _mm_setzero_si128());
+        int32_t out = _mm_cvtsi128_si32(packed);
+        std::memcpy(flags + i, &out, sizeof(out));
+
+        flagged += BIT_COUNT[_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(bits, _mm_setzero_si128())))];
+    }
+    return flagged + checkArrowsScalar(field, params, flags, i, count);
+}
+
+ARROW_TARGET_AVX2
+static size_t runAVX2(const ArrowField& field, const ArrowCheckParams& params, uint8_t* flags) {
+    const float* base = field.getBase();
+    const uint8_t* lane = field.getLane();
+    const uint8_t* state = field.getState();
+    size_t count = field.size();
+
+    // 8 entry table, only the first 4 are ever indexed
+    const __m256 lowTable = _mm256_setr_ps(params.hitLow[0], params.hitLow[1], params.hitLow[2], params.hitLow[3],
+                                           0, 0, 0, 0);
+    const __m256 travel = _mm256_set1_ps(field.getTravel()), prevTravel = _mm256_set1_ps(field.getPrevTravel());
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256i liveState = _mm256_set1_epi32(ArrowField::LIVE);
+    const __m256i missedBit = _mm256_set1_epi32(ARROW_MISSED);
+    const __m256i expiredBit = _mm256_set1_epi32(ARROW_EXPIRED);
+
+    size_t flagged = 0, i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(lane + i)));
+        __m256i states = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(state + i)));
+        __m256i live = _mm256_cmpeq_epi32(states, liveState);
+        __m256 low = _mm256_permutevar8x32_ps(lowTable, lanes);
+
+        __m256 arrowBase = _mm256_loadu_ps(base + i);
+        __m256 oldY = _mm256_add_ps(arrowBase, prevTravel);
+        __m256 newY = _mm256_add_ps(arrowBase, travel);
+
+        __m256i passedLow = _mm256_castps_si256(_mm256_and_ps(_mm256_cmp_ps(low, oldY, _CMP_LT_OQ),
+                                                              _mm256_cmp_ps(newY, low, _CMP_LE_OQ)));
+        __m256i missed = _mm256_and_si256(live, passedLow);
+        __m256i expired = _mm256_castps_si256(_mm256_cmp_ps(newY, zero, _CMP_LT_OQ));
+
+        __m256i bits = _mm256_or_si256(_mm256_and_si256(missed, missedBit), _mm256_and_si256(expired, expiredBit));
+        __m128i words = _mm_packs_epi32(_mm256_castsi256_si128(bits), _mm256_extracti128_si256(bits, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(flags + i), _mm_packus_epi16(words, words));
+
+        int any = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(bits, _mm256_setzero_si256())));
+        flagged += BIT_COUNT[any & 0xF] + BIT_COUNT[any >> 4];
+    }
+    return flagged + checkArrowsScalar(field, params, flags, i, count);
+}
+
+static bool cpuHasAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    // the kernel is picked during static initialization, which may run before the CPU model is filled in
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // ARROW_KERNELS_X86
+
+typedef size_t (*CheckArrowsFn)(const ArrowField&, const ArrowCheckParams&, uint8_t*);
+
+static ArrowKernel bestKernel() {
+#ifdef ARROW_KERNELS_X86
+    return cpuHasAVX2() ? ArrowKernel::AVX2 : ArrowKernel::SSE2;
+#else
+    return ArrowKernel::SCALAR;
+#endif
+}
+
+static CheckArrowsFn kernelFunction(ArrowKernel kernel) {
+    switch (kernel) {
+#ifdef ARROW_KERNELS_X86
+        case ArrowKernel::SSE2: return runSSE2;
+        case ArrowKernel::AVX2: return runAVX2;
+#endif
+        default: return runScalar;
+    }
+}
+
+static ArrowKernel currentKernel = bestKernel();
+static CheckArrowsFn currentFunction = kernelFunction(currentKernel);
+
+size_t checkArrows(const ArrowField& field, const ArrowCheckParams& params, uint8_t* flags) {
+    return currentFunction(field, params, flags);
+}
+
+ArrowKernel getArrowKernel() {
+    return currentKernel;
+}
+
+bool setArrowKernel(ArrowKernel kernel) {
+#ifdef ARROW_KERNELS_X86
+    if (kernel == ArrowKernel::AVX2 && !cpuHasAVX2())
+        return false;
+#else
+    if (kernel != ArrowKernel::SCALAR)
+        return false;
+#endif
+    currentKernel = kernel;
+    currentFunction = kernelFunction(kernel);
+    return true;
+}
+
+const char* getArrowKernelName(ArrowKernel kernel) {
+    switch (kernel) {
+        case ArrowKernel::SSE2: return "sse2";
+        case ArrowKernel::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef GRAPHICS_ARROWKERNELS_H
+#define GRAPHICS_ARROWKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "arrowField.h"
+
+/// @brief What happened to an arrow during a step, written per arrow by checkArrows().
+enum ArrowFlag : uint8_t {
+    /// The live arrow left the bottom of its lane's hit window this step, so it can no longer be hit
+    ARROW_MISSED = 1 << 0,
+    /// The arrow fell below the screen
+    ARROW_EXPIRED = 1 << 1
+};
+
+/// @brief Inputs of one arrow check.
+struct ArrowCheckParams {
+    /// @brief Per lane, the y an arrow's center has to stay above to still be hit
+    float hitLow[4];
+};
+
+/// @brief Implementations of checkArrows()
+enum class ArrowKernel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+/**
+ * @brief Checks every arrow of the field against its hit window after ArrowField::moveTo(), in one read-only pass
+ * @details Each arrow's y before and after the move is evaluated from its base and the field's travel; a live
+ * arrow is flagged missed if it just passed its lane's hitLow, and any arrow is flagged expired if it is below the
+ * screen. Nothing in the field is written, the caller acts on the flags.
+ * All implementations give bit-identical results, so replays stay valid whichever one the CPU picks.
+ *
+ * @param field The arrows to check
+ * @param params Hit windows
+ * @param flags Output, receives ArrowFlag bits for each of the field.size() arrows
+ * @return The number of arrows with at least one flag set
+ */
+size_t checkArrows(const ArrowField& field, const ArrowCheckParams& params, uint8_t* flags);
+
+/// @brief Returns the implementation checkArrows() uses
+/// @details Defaults to the fastest one the CPU supports.
+ArrowKernel getArrowKernel();
+
+/// @brief Forces an implementation, e.g. to compare them
+/// @return false if the CPU does not support it (the current one is kept)
+bool setArrowKernel(ArrowKernel kernel);
+
+/// @brief Returns the name of an implementation ("scalar", "sse2" or "avx2")
+const char* getArrowKernelName(ArrowKernel kernel);
+
+#endif //GRAPHICS_ARROWKERNELS_H
@@ -0,0 +1,190 @@
+#include "chart.h"
+#include "../util/binaryIO.h"
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+using std::cout, std::endl;
+
+static const char MAGIC[4] = {'A', 'D', 'C', 'H'};
+static const uint16_t VERSION = 1;
+static const size_t HEADER_SIZE = 32;
+
+/// Notes per index block
+static const uint32_t BLOCK_SIZE = 4096;
+
+/// How far ahead of the read position pages are prefetched, and how much is read before pages behind are released
+static const size_t WINDOW_SIZE = 64 * 1024;
+
+static uint64_t toMicroseconds(double seconds) {
+    return seconds <= 0 ? 0 : static_cast<uint64_t>(std::llround(seconds * 1e6));
+}
+
+// --------------------------------------------------------
+// ChartWriter
+// --------------------------------------------------------
+
+bool ChartWriter::open(const string& path) {
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        cout << "ERROR::CHART: Could not open " << path << " for writing" << endl;
+        return false;
+    }
+    // the header is written again by finish(), once the counts are known
+    char header[HEADER_SIZE] = {};
+    out.write(header, sizeof(header));
+    noteCount = 0;
+    lastTime = 0;
+    blockTimes.clear();
+    blockOffsets.clear();
+    return true;
+}
+
+void ChartWriter::addNote(double time, Lane lane) {
+    uint64_t us = toMicroseconds(time);
+    if (us < lastTime) us = lastTime; // notes must be in order, clamp rather than corrupt the deltas
+
+    if (noteCount % BLOCK_SIZE == 0) {
+        blockTimes.push_back(lastTime);
+        blockOffsets.push_back(static_cast<uint64_t>(out.tellp()));
+    }
+    writeVarint(out, ((us - lastTime) << 2) | (lane & 3));
+    lastTime = us;
+    noteCount++;
+}
+
+bool ChartWriter::finish() {
+    uint64_t indexOffset = static_cast<uint64_t>(out.tellp());
+    for (size_t i = 0; i < blockTimes.size(); i++) {
+        writeLE<uint64_t>(out, blockTimes[i]);
+        writeLE<uint64_t>(out, blockOffsets[i]);
+    }
+
+    out.seekp(0);
+    out.write(MAGIC, sizeof(MAGIC));
+    writeLE<uint16_t>(out, VERSION);
+    writeLE<uint16_t>(out, 0);
+    writeLE<uint32_t>(out, noteCount);
+    writeLE<uint32_t>(out, BLOCK_SIZE);
+    writeLE<uint32_t>(out, static_cast<uint32_t>(blockTimes.size()));
+    writeLE<uint32_t>(out, 0);
+    writeLE<uint64_t>(out, indexOffset);
+
+    bool ok = static_cast<bool>(out);
+    out.close();
+    if (!ok)
+        cout << "ERROR::CHART: Failed writing chart" << endl;
+    return ok;
+}
+
+// --------------------------------------------------------
+// ChartStream
+// --------------------------------------------------------
+
+bool ChartStream::open(const string& path) {
+    hasNote = false;
+    if (!file.open(path))
+        return false;
+
+    const uint8_t* data = file.getData();
+    if (file.getSize() < HEADER_SIZE || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        cout << "ERROR::CHART: " << path << " is not a chart file" << endl;
+        return false;
+    }
+    if (loadLE<uint16_t>(data + 4) != VERSION) {
+        cout << "ERROR::CHART: Unsupported chart version " << loadLE<uint16_t>(data + 4) << endl;
+        return false;
+    }
+    noteCount = loadLE<uint32_t>(data + 8);
+    blockSize = loadLE<uint32_t>(data + 12);
+    blockCount = loadLE<uint32_t>(data + 16);
+    indexOffset = loadLE<uint64_t>(data + 24);
+    if (blockSize == 0 || indexOffset < HEADER_SIZE || indexOffset > file.getSize() ||
+        (file.getSize() - indexOffset) / 16 < blockCount ||
+        blockCount != (noteCount + blockSize - 1) / blockSize) {
+        cout << "ERROR::CHART: " << path << " has a corrupt header" << endl;
+        return false;
+    }
+
+    file.adviseSequential();
+    seek(0);
+    return true;
+}
+
+void ChartStream::seek(double time) {
+    uint64_t target = toMicroseconds(time);
+    const uint8_t* index = file.getData() + indexOffset;
+
+    // find the last block starting at or before the target
+    uint32_t low = 0, high = blockCount;
+    while (high - low > 1) {
+        uint32_t mid = (low + high) / 2;
+        if (loadLE<uint64_t>(index + mid * 16) <= target) low = mid;
+        else high = mid;
+    }
+
+    hasNote = false;
+    nextNote = low * blockSize;
+    noteTime = blockCount > 0 ? loadLE<uint64_t>(index + low * 16) : 0;
+    cursor = blockCount > 0 ? static_cast<size_t>(loadLE<uint64_t>(index + low * 16 + 8)) : HEADER_SIZE;
+    releasedTo = prefetchedTo = cursor;
+
+    // decode forward to the first note at or after the target
+    decodeNext();
+    while (hasNote && noteTime < target)
+        decodeNext();
+}
+
+void ChartStream::setPosition(const ChartPosition& position) {
+    cursor = position.cursor;
+    nextNote = position.nextNote;
+    hasNote = position.hasNote;
+    noteTime = position.noteTime;
+    noteLane = position.noteLane;
+    releasedTo = prefetchedTo = cursor;
+    updateWindow();
+}
+
+bool ChartStream::next(double now, SpawnEvent& event) {
+    if (!hasNote || noteTime > toMicroseconds(now))
+        return false;
+
+    event = {noteTime / 1e6, noteLane, SPAWN_ALWAYS};
+    decodeNext();
+    return true;
+}
+
+void ChartStream::decodeNext() {
+    if (nextNote >= noteCount || cursor >= indexOffset) {
+        hasNote = false;
+        return;
+    }
+
+    const uint8_t* position = file.getData() + cursor;
+    uint64_t packed;
+    if (!decodeVarint(position, file.getData() + indexOffset, packed)) {
+        cout << "ERROR::CHART: Corrupt note " << nextNote << ", stopping the chart" << endl;
+        hasNote = false;
+        return;
+    }
+    cursor = position - file.getData();
+    noteTime += packed >> 2;
+    noteLane = static_cast<Lane>(packed & 3);
+    nextNote++;
+    hasNote = true;
+    updateWindow();
+}
+
+void ChartStream::updateWindow() {
+    // keep the next window of notes loading in the background
+    if (cursor + WINDOW_SIZE / 2 > prefetchedTo) {
+        file.prefetch(cursor, WINDOW_SIZE);
+        prefetchedTo = cursor + WINDOW_SIZE;
+    }
+    // and hand back what has been read
+    if (cursor - releasedTo >= WINDOW_SIZE) {
+        file.release(releasedTo, cursor - releasedTo);
+        releasedTo = cursor;
+    }
+}
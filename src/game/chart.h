@@ -0,0 +1,118 @@
+#ifndef GRAPHICS_CHART_H
+#define GRAPHICS_CHART_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "lane.h"
+#include "spawnScheduler.h"
+#include "../util/mappedFile.h"
+
+using std::string, std::vector;
+
+/*
+ * Chart file layout (little endian):
+ *   header: "ADCH", u16 version, u16 reserved, u32 noteCount, u32 blockSize, u32 blockCount, u32 reserved,
+ *           u64 indexOffset
+ *   notes:  noteCount x varint((microseconds since previous note << 2) | lane)
+ *   index:  blockCount x { u64 time of the note before the block (us), u64 file offset of the block }
+ * A note's time is the play time its arrow enters the top of the screen. Notes are grouped in blocks of blockSize
+ * notes; the index lets a reader start decoding at any block.
+ */
+
+/**
+ * @brief Writes a chart file
+ * @details Notes are written as they are added, so authoring tools can stream charts of any length.
+ */
+class ChartWriter {
+public:
+    /// @brief Creates the chart file
+    /// @return true if successful, false otherwise
+    bool open(const string& path);
+
+    /// @brief Appends a note
+    /// @param time Play time in seconds, must not be before the previous note
+    /// @param lane The lane the note's arrow falls in
+    void addNote(double time, Lane lane);
+
+    /// @brief Writes the index and header and closes the file
+    /// @return true if successful, false otherwise
+    bool finish();
+
+private:
+    std::ofstream out;
+    uint32_t noteCount = 0;
+    uint64_t lastTime = 0;
+
+    /// @brief Index entries, one per blockSize notes
+    vector<uint64_t> blockTimes, blockOffsets;
+};
+
+/// @brief Where a ChartStream is reading, saved to return to it later
+struct ChartPosition {
+    size_t cursor = 0;
+    uint32_t nextNote = 0;
+    bool hasNote = false;
+    uint64_t noteTime = 0;
+    Lane noteLane = LANE_LEFT;
+};
+
+/**
+ * @brief Reads a chart from a memory mapped file, note by note
+ * @details Only the next note is decoded, and the mapped pages are loaded just ahead of the read position and
+ * dropped behind it, so resident memory stays the same whatever the chart length.
+ */
+class ChartStream {
+public:
+    /// @brief Maps and validates a chart file
+    /// @return true if successful, false otherwise
+    bool open(const string& path);
+
+    /// @brief Moves the read position to the first note at or after a play time
+    void seek(double time);
+
+    /// @brief Returns the read position, to go back to it with setPosition()
+    ChartPosition getPosition() const { return {cursor, nextNote, hasNote, noteTime, noteLane}; }
+
+    /// @brief Returns to a read position of this chart, exactly where getPosition() left it
+    void setPosition(const ChartPosition& position);
+
+    /// @brief Pops the next note if it is due
+    /// @param now Current play time in seconds
+    /// @param event Receives the note as a spawn event
+    /// @return false if the next note is after now, or the chart is finished
+    bool next(double now, SpawnEvent& event);
+
+    /// @brief Returns true once every note has been read
+    bool isFinished() const { return !hasNote; }
+
+    /// @brief Returns the number of notes in the chart
+    uint32_t getNoteCount() const { return noteCount; }
+
+private:
+    MappedFile file;
+    uint32_t noteCount = 0, blockSize = 0, blockCount = 0;
+    uint64_t indexOffset = 0;
+
+    /// @brief Read position: byte offset of the note after the decoded one, and that note's number
+    size_t cursor = 0;
+    uint32_t nextNote = 0;
+
+    /// @brief The decoded next note
+    bool hasNote = false;
+    uint64_t noteTime = 0;
+    Lane noteLane = LANE_LEFT;
+
+    /// @brief Mapped bytes before this offset have been released, bytes before prefetchedTo requested
+    size_t releasedTo = 0, prefetchedTo = 0;
+
+    /// @brief Decodes the note at the cursor into the next note
+    void decodeNext();
+
+    /// @brief Releases pages behind the cursor and prefetches the ones ahead of it
+    void updateWindow();
+};
+
+#endif //GRAPHICS_CHART_H
@@ -0,0 +1,16 @@
+#ifndef GRAPHICS_LANE_H
+#define GRAPHICS_LANE_H
+
+#include <cstdint>
+
+/// @brief The lanes arrows fall in, from left to right.
+/// @details Also the index into any per-lane array.
+enum Lane : uint8_t {
+    LANE_LEFT = 0,
+    LANE_DOWN = 1,
+    LANE_UP = 2,
+    LANE_RIGHT = 3,
+    LANE_COUNT = 4
+};
+
+#endif //GRAPHICS_LANE_H
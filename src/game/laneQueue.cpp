@@ -0,0 +1,42 @@
+#include "laneQueue.h"
+
+LaneQueue::LaneQueue(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity)
+        size *= 2;
+    ring.resize(size);
+}
+
+void LaneQueue::push(ArrowHandle handle) {
+    if (count == ring.size()) {
+        // unroll the ring into a buffer twice the size
+        vector<ArrowHandle> bigger(ring.size() * 2);
+        for (size_t i = 0; i < count; i++)
+            bigger[i] = ring[(head + i) & (ring.size() - 1)];
+        ring.swap(bigger);
+        head = 0;
+    }
+    ring[(head + count) & (ring.size() - 1)] = handle;
+    count++;
+}
+
+bool LaneQueue::front(const ArrowField& field, ArrowHandle& handle) {
+    while (count > 0) {
+        if (field.isValid(ring[head])) {
+            handle = ring[head];
+            return true;
+        }
+        pop();
+    }
+    return false;
+}
+
+void LaneQueue::pop() {
+    head = (head + 1) & (ring.size() - 1);
+    count--;
+}
+
+void LaneQueue::clear() {
+    head = 0;
+    count = 0;
+}
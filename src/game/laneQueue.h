@@ -0,0 +1,46 @@
+#ifndef GRAPHICS_LANEQUEUE_H
+#define GRAPHICS_LANEQUEUE_H
+
+#include <cstddef>
+#include <vector>
+
+#include "arrowField.h"
+
+using std::vector;
+
+/**
+ * @brief The arrows of one lane that can still be hit, lowest first
+ * @details All arrows fall at the same speed, so the arrows of a lane reach the marker in the order they were
+ * spawned. The queue is a ring buffer of handles: spawning pushes to the back, and a press only has to look at the
+ * front. Arrows removed from the field are skipped lazily when they reach the front.
+ */
+class LaneQueue {
+public:
+    /// @brief Construct a new Lane Queue object
+    /// @param capacity Number of handles to reserve memory for (rounded up to a power of two)
+    explicit LaneQueue(size_t capacity = 64);
+
+    /// @brief Adds a newly spawned arrow to the back of the queue
+    void push(ArrowHandle handle);
+
+    /// @brief Finds the lowest arrow of the lane that still exists in the field
+    /// @param field The field the handles refer to
+    /// @param handle Receives the arrow's handle
+    /// @return false if the lane has no arrow left
+    bool front(const ArrowField& field, ArrowHandle& handle);
+
+    /// @brief Removes the front handle
+    void pop();
+
+    /// @brief Removes all handles
+    void clear();
+
+    /// @brief Returns the number of queued handles (including ones not skipped yet)
+    size_t size() const { return count; }
+
+private:
+    vector<ArrowHandle> ring;
+    size_t head = 0, count = 0;
+};
+
+#endif //GRAPHICS_LANEQUEUE_H
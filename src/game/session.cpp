@@ -0,0 +1,276 @@
+#include "session.h"
+#include "../util/hash.h"
+
+#include <algorithm>
+#include <limits>
+
+SessionLayout::SessionLayout(unsigned int width, unsigned int height) : width(width), height(height) {
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        laneX[lane] = (width * (2 * lane + 1)) / 8;
+        markerY[lane] = height / 6;
+    }
+    // the up arrow is drawn pointing up, its marker sits lower so it lines up with the others
+    markerY[LANE_UP] = height / 6 - 25;
+
+    // an arrow scores if it is within 20 pixels above or below its marker, and only in the last 3rd of the screen.
+    // Stored as the range of the arrow's center so the arrow kernel only compares y.
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        hitLow[lane] = markerY[lane] - MARKER_HEIGHT / 2 - 20 + ArrowField::HEIGHT / 2;
+        hitHigh[lane] = std::min(markerY[lane] + MARKER_HEIGHT / 2 + 20, height / 3.0f) - ArrowField::HEIGHT / 2;
+    }
+}
+
+Session::Session(const EngineConfig& config, const SessionLayout& layout) : layout(layout) {
+    // a step rarely spawns or removes more than a few arrows, reserving keeps steady state steps allocation free
+    spawned.reserve(64);
+    removed.reserve(64);
+    reset(config);
+}
+
+void Session::reset(const EngineConfig& config) {
+    this->config = config;
+    spawner.reset(config.seed);
+    if (chart)
+        chart->seek(0);
+    screen = SCREEN_START;
+    totalScore = 0;
+    speed = config.startSpeed;
+    playStartTick = 0;
+    tick = 0;
+    stepTime = 1.0 / config.simRate;
+    buttons = 0;
+    flashLanes = 0;
+    hitLanes = 0;
+    speedCurve.clear();
+    spawned.clear();
+    removed.clear();
+    arrows.clear();
+    for (LaneQueue& queue : laneQueues)
+        queue.clear();
+}
+
+void Session::snapshot(SessionSnapshot& out) const {
+    out.screen = screen;
+    out.totalScore = totalScore;
+    out.speed = speed;
+    out.playStartTick = playStartTick;
+    out.tick = tick;
+    out.buttons = buttons;
+    out.flashLanes = flashLanes;
+    out.spawner = spawner;
+    if (chart)
+        out.chartPosition = chart->getPosition();
+    out.speedCurve = speedCurve;
+    out.arrows = arrows;
+    std::copy(laneQueues, laneQueues + LANE_COUNT, out.laneQueues);
+    out.valid = true;
+}
+
+void Session::restore(const SessionSnapshot& in) {
+    screen = in.screen;
+    totalScore = in.totalScore;
+    speed = in.speed;
+    playStartTick = in.playStartTick;
+    tick = in.tick;
+    buttons = in.buttons;
+    flashLanes = in.flashLanes;
+    hitLanes = 0;
+    spawner = in.spawner;
+    speedCurve = in.speedCurve;
+    arrows = in.arrows;
+    std::copy(in.laneQueues, in.laneQueues + LANE_COUNT, laneQueues);
+    spawned.clear();
+    removed.clear();
+    // the chart carries on with the first note the snapshot had not spawned yet
+    if (chart)
+        chart->setPosition(in.chartPosition);
+    if (screen == SCREEN_PLAY)
+        emit(TELEMETRY_START, 0);
+}
+
+bool Session::loadChart(const string& path) {
+    auto stream = std::make_unique<ChartStream>();
+    if (!stream->open(path))
+        return false;
+    chart = std::move(stream);
+    return true;
+}
+
+void Session::step(uint8_t buttons) {
+    uint8_t pressedNow = buttons & ~this->buttons;
+    this->buttons = buttons;
+    hitLanes = 0;
+    spawned.clear();
+    removed.clear();
+    Screen previousScreen = screen;
+
+    // DONE: If we're in the start screen and the user presses s, change screen to play
+    if (screen == SCREEN_START && (buttons & BUTTON_START)) {
+        screen = SCREEN_PLAY;
+        playStartTick = tick;
+        speedCurve.setMove(tick, stepMove());
+        emit(TELEMETRY_START, 0);
+    }
+
+    if (screen == SCREEN_PLAY) {
+        // log how far off each new press is from its lane's next arrow
+        if (telemetry) {
+            for (int lane = 0; lane < LANE_COUNT; lane++) {
+                if (!(pressedNow & (1 << lane)))
+                    continue;
+                ArrowHandle front;
+                float offset = std::numeric_limits<float>::quiet_NaN();
+                if (laneQueues[lane].front(arrows, front))
+                    offset = timingOffset(static_cast<Lane>(lane), arrows.indexOf(front));
+                emit(TELEMETRY_PRESS, lane, offset);
+            }
+        }
+
+        // check every pressed lane for a scored arrow; releasing all of them ends the divider flash
+        if (!(buttons & (BUTTON_LEFT | BUTTON_DOWN | BUTTON_UP | BUTTON_RIGHT)))
+            flashLanes = 0;
+        for (int lane = 0; lane < LANE_COUNT; lane++) {
+            if (buttons & (1 << lane))
+                addPoint(static_cast<Lane>(lane));
+        }
+
+        // spawn every arrow the timeline has due: one every second, and more as speed and score go up
+        double playTime = getPlayTime();
+        // (or every note of the chart, when one is loaded)
+        SpawnEvent event;
+        if (chart) {
+            while (chart->next(playTime, event))
+                spawnArrow(event.lane, playTime - event.time);
+            if (chart->isFinished() && arrows.size() == 0)
+                screen = SCREEN_OVER;
+        } else {
+            while (spawner.next(playTime, event)) {
+                if (spawnRuleHolds(event.rule))
+                    spawnArrow(event.lane, playTime - event.time);
+            }
+        }
+
+        // move arrows down the screen to where the speed curve has them after this step (one write to the field's
+        // distance), then check which can no longer be scored
+        arrows.moveTo(speedCurve.distanceAt(tick + 1));
+        ArrowCheckParams params;
+        std::copy(layout.hitLow, layout.hitLow + LANE_COUNT, params.hitLow);
+        if (arrowFlags.size() < arrows.size())
+            arrowFlags.resize(arrows.capacity());
+
+        if (checkArrows(arrows, params, arrowFlags.data()) > 0) {
+            // walk backwards, so the arrow moved into a removed arrow's index has already been handled
+            const uint8_t* lane = arrows.getLane();
+            for (size_t i = arrows.size(); i-- > 0;) {
+                if (arrowFlags[i] & ARROW_MISSED)
+                    emit(TELEMETRY_MISS, lane[i]);
+                // if arrows are not scored and past the screen, its game over.
+                if (arrowFlags[i] & ARROW_EXPIRED) {
+                    screen = SCREEN_OVER;
+                    removed.push_back(arrows.handleAt(i));
+                    arrows.remove(i);
+                }
+            }
+
+            // missed arrows are the lowest of their lane, so the next hittable one is the first above the window
+            // (several arrows of a lane can leave it in the same step, in any index order)
+            for (int l = 0; l < LANE_COUNT; l++) {
+                ArrowHandle front;
+                while (laneQueues[l].front(arrows, front) && arrows.getY(arrows.indexOf(front)) <= layout.hitLow[l])
+                    laneQueues[l].pop();
+            }
+        }
+    }
+
+    if (screen == SCREEN_OVER && previousScreen != SCREEN_OVER) {
+        // this step was the last to move the arrows
+        speedCurve.setMove(tick + 1, 0.0f);
+        emit(TELEMETRY_END, 0);
+    }
+    tick++;
+}
+
+uint64_t Session::hashState() const {
+    Hash hash;
+    hash.add(tick);
+    hash.add(screen);
+    hash.add(totalScore);
+    hash.add(speed);
+    hash.add(spawner.getRandomState());
+    for (size_t i = 0; i < arrows.size(); i++) {
+        hash.add(arrows.getX()[i]);
+        hash.add(arrows.getY(i));
+        hash.add(arrows.getState()[i]);
+    }
+    return hash.get();
+}
+
+// adds point by checking the lowest arrow of a lane against its marker.
+// PARAM: 'lane' is used to determine which quadrant to check for a scored arrow.
+void Session::addPoint(Lane lane) {
+    ArrowHandle handle;
+    if (!laneQueues[lane].front(arrows, handle))
+        return;
+
+    // if the arrow is within 20 pixels above or below the marker, it is scored
+    size_t i = arrows.indexOf(handle);
+    float y = arrows.getY(i);
+    if (y <= layout.hitLow[lane] || y >= layout.hitHigh[lane])
+        return;
+    if (telemetry)
+        emit(TELEMETRY_HIT, lane, timingOffset(lane, i));
+    laneQueues[lane].pop();
+    removed.push_back(handle);
+    arrows.remove(i);
+
+    // increase score counter by 5, and speed up
+    float previousSpeed = speed;
+    totalScore+= 5;
+    if(speed > -4){
+        speed-= 0.08;
+    }
+
+    if(totalScore > 500 && speed < -8){
+        speed-= 0.01;
+    }
+
+    if (speed != previousSpeed) {
+        // the move at the end of this step already has the new speed
+        speedCurve.setMove(tick, stepMove());
+        emit(TELEMETRY_SPEED, lane, speed);
+    }
+
+    // the renderer adds emphasis on the success click by changing the divider color
+    flashLanes |= 1 << lane;
+    hitLanes |= 1 << lane;
+}
+
+float Session::timingOffset(Lane lane, size_t i) const {
+    // the arrow is right on time when its center is in the middle of the hit window
+    float centerY = (layout.hitLow[lane] + layout.hitHigh[lane]) / 2;
+    return static_cast<float>(getTimeUntil(i, centerY));
+}
+
+double Session::getTimeUntil(size_t i, float y) const {
+    // the arrow is at y once the field has fallen to the distance that makes base + travel = y, the speed curve
+    // tells the tick that distance is reached at
+    double distance = arrows.getOrigin() + (y - arrows.getBase()[i]);
+    return (speedCurve.tickAt(distance) - tick) * stepTime;
+}
+
+void Session::spawnArrow(Lane lane, double lateBy) {
+    // adds an arrow at the top of the lane, moved down by the distance it would have fallen since it was due
+    float y = layout.height + speed * REFERENCE_RATE * lateBy;
+    ArrowHandle handle = arrows.spawn(layout.laneX[lane], y, lane, tick * stepTime);
+    laneQueues[lane].push(handle);
+    spawned.push_back(handle);
+}
+
+bool Session::spawnRuleHolds(SpawnRule rule) const {
+    switch (rule) {
+        case SPAWN_FAST: return speed < -2.5;
+        case SPAWN_FASTER: return speed < -3.5;
+        case SPAWN_HIGH_SCORE: return totalScore > 150;
+        default: return true;
+    }
+}
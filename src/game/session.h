@@ -0,0 +1,252 @@
+#ifndef GRAPHICS_SESSION_H
+#define GRAPHICS_SESSION_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../engineConfig.h"
+#include "arrowField.h"
+#include "arrowKernels.h"
+#include "chart.h"
+#include "lane.h"
+#include "laneQueue.h"
+#include "spawnScheduler.h"
+#include "speedCurve.h"
+#include "../telemetry/telemetry.h"
+
+using std::string, std::unique_ptr, std::vector;
+
+/// @brief Buttons that affect the game, packed into a bitmask for input recording.
+enum Button : uint8_t {
+    BUTTON_LEFT = 1 << 0,
+    BUTTON_DOWN = 1 << 1,
+    BUTTON_UP = 1 << 2,
+    BUTTON_RIGHT = 1 << 3,
+    BUTTON_START = 1 << 4
+};
+
+/// @brief The screen a session is on.
+enum Screen { SCREEN_START, SCREEN_PLAY, SCREEN_OVER };
+
+/// @brief Where lanes, markers and hit windows are on the playfield.
+struct SessionLayout {
+    /// @brief Size of the playfield in pixels; arrows spawn at the top edge.
+    unsigned int width, height;
+
+    /// @brief Per lane, the x of the arrows and the center y of the marker arrow.
+    float laneX[LANE_COUNT], markerY[LANE_COUNT];
+
+    /// @brief Per lane, the range an arrow's center has to be in to be hit (exclusive).
+    float hitLow[LANE_COUNT], hitHigh[LANE_COUNT];
+
+    /// @brief Height of the marker arrows.
+    static constexpr float MARKER_HEIGHT = 31.25f;
+
+    /// @brief Lays the four lanes out evenly across a playfield of the given size.
+    SessionLayout(unsigned int width = 800, unsigned int height = 600);
+};
+
+/**
+ * @brief Everything a session's fixed steps change, copied out to return to that point later
+ * @details Taking a snapshot into the same object again copy-assigns into the arrays it already holds, so once
+ * they are large enough neither snapshot() nor restore() allocates.
+ */
+struct SessionSnapshot {
+    Screen screen = SCREEN_START;
+    int totalScore = 0;
+    float speed = 0.0f;
+    uint32_t playStartTick = 0, tick = 0;
+    uint8_t buttons = 0, flashLanes = 0;
+
+    /// @brief The spawn timeline, including its random generator
+    SpawnScheduler spawner;
+
+    /// @brief Where the loaded chart was reading, if any
+    ChartPosition chartPosition;
+
+    SpeedCurve speedCurve;
+    ArrowField arrows;
+    LaneQueue laneQueues[LANE_COUNT];
+
+    /// @brief Whether snapshot() was called on this object
+    bool valid = false;
+};
+
+/**
+ * @brief The simulation of one game, without a window.
+ * @details Owns everything a fixed step reads or writes, so any number of sessions can run side by side on
+ * different threads. The Engine drives one session from the keyboard and draws it; the bot simulator runs
+ * thousands of them headless.
+ */
+class Session {
+public:
+    /// @brief Speeds are tuned in pixels per frame at this rate; steps scale them by REFERENCE_RATE / simRate.
+    static constexpr float REFERENCE_RATE = 60.0f;
+
+    /// @brief Construct a new Session on the start screen
+    /// @param config The configuration to start the session with (the seed must already be picked)
+    /// @param layout Where lanes and hit windows are
+    explicit Session(const EngineConfig& config, const SessionLayout& layout = SessionLayout());
+
+    /// @brief Restarts the session on the start screen with a new configuration
+    /// @details A loaded chart is kept and rewound to its start.
+    void reset(const EngineConfig& config);
+
+    /// @brief Copies the game state (arrows, score, speed, spawn timeline or chart position, screen and tick) into a
+    ///        snapshot
+    void snapshot(SessionSnapshot& out) const;
+
+    /// @brief Returns the session to the state a snapshot was taken in
+    /// @details The snapshot has to come from this session since its last reset(), the configuration is not part of
+    ///          it. A loaded chart goes back to the note it was at. Restoring into the play screen logs a
+    ///          start record, so telemetry shows where the ticks go back.
+    void restore(const SessionSnapshot& in);
+
+    /// @brief Spawns arrows from an authored chart file instead of the random spawn scheduler.
+    /// @details The session ends once every note of the chart has been played.
+    /// @return true if the chart was loaded, false otherwise
+    bool loadChart(const string& path);
+
+    /// @brief Sends hits, misses, presses, speed changes and the final score to a telemetry writer
+    /// @param writer The writer to push records to (nullptr to stop)
+    void setTelemetry(TelemetryWriter* writer) { telemetry = writer; }
+
+    /// @brief Advances the simulation by one fixed step of getStepTime() seconds.
+    /// @details Applies the buttons, spawns arrows, then moves them and checks for misses with checkArrows().
+    /// @param buttons Bitmask of Button values held during this step
+    void step(uint8_t buttons);
+
+    /// @brief Returns a hash of the game state, used to detect replay divergence.
+    uint64_t hashState() const;
+
+    /// @brief Finds the lowest arrow of a lane that can still be hit
+    /// @return false if the lane has no hittable arrow
+    bool getLaneFront(Lane lane, ArrowHandle& handle) { return laneQueues[lane].front(arrows, handle); }
+
+    /// @brief Returns how early (positive) or late a press now would be for arrow i of a lane, in seconds
+    float timingOffset(Lane lane, size_t i) const;
+
+    /// @brief Returns the field's travel at a tick, from the speed curve; an arrow's y then is its base + the travel
+    /// @details Fractional ticks give the travel between two steps, exactly as the steps compute it. Ticks still to
+    ///          come assume the speed does not change again.
+    float getTravelAt(double tick) const { return arrows.travelAt(speedCurve.distanceAt(tick)); }
+
+    /// @brief Returns the seconds until arrow i has fallen to y, negative if it passed y that long ago
+    /// @details The time comes straight from the speed curve: a y still to come assumes the speed does not change
+    ///          again, a y already passed takes the speed ups since into account.
+    /// @return infinity if the arrow never gets there (the session is over)
+    double getTimeUntil(size_t i, float y) const;
+
+    // -----------------------------------
+    // Getters
+    // -----------------------------------
+
+    const EngineConfig& getConfig() const { return config; }
+    const SessionLayout& getLayout() const { return layout; }
+    const ArrowField& getArrows() const { return arrows; }
+    Screen getScreen() const { return screen; }
+    int getScore() const { return totalScore; }
+    float getSpeed() const { return speed; }
+
+    /// @brief Returns the speed arrows fall at, in pixels per second
+    float getFallSpeed() const { return -speed * REFERENCE_RATE; }
+
+    /// @brief Returns the number of steps run so far
+    uint32_t getTick() const { return tick; }
+
+    /// @brief Returns the length of one step in seconds (1 / simRate)
+    double getStepTime() const { return stepTime; }
+
+    /// @brief Returns the seconds spent on the play screen so far
+    double getPlayTime() const { return screen == SCREEN_START ? 0.0 : (tick - playStartTick) * stepTime; }
+
+    /// @brief Returns the buttons applied by the last step
+    uint8_t getButtons() const { return buttons; }
+
+    /// @brief Returns a bit per lane (1 << Lane) that scored while its button was held, until all are released
+    uint8_t getFlashLanes() const { return flashLanes; }
+
+    /// @brief Returns a bit per lane (1 << Lane) that scored during the last step
+    uint8_t getHitLanes() const { return hitLanes; }
+
+
+    /// @brief Returns the arrows spawned and removed (scored or expired) during the last step
+    /// @details An arrow can appear in both, in which case it is no longer in the field.
+    const vector<ArrowHandle>& getSpawned() const { return spawned; }
+    const vector<ArrowHandle>& getRemoved() const { return removed; }
+
+private:
+    /// @brief Spawns a new arrow at the top of a lane.
+    /// @param lane The lane to spawn in
+    /// @param lateBy Seconds since the spawn was due; the arrow starts as far down as it would have fallen by now
+    void spawnArrow(Lane lane, double lateBy);
+
+    /// @brief Returns true if a scheduled spawn with this rule should happen in the current game state.
+    bool spawnRuleHolds(SpawnRule rule) const;
+
+    /// @brief Returns the distance the current speed moves arrows in one step
+    float stepMove() const { return speed * (REFERENCE_RATE / config.simRate); }
+
+    /// @brief Pushes a telemetry record, if a writer is set
+    void emit(TelemetryType type, int lane, float value = 0.0f) {
+        if (telemetry)
+            telemetry->push({tick, type, static_cast<uint8_t>(lane), 0, value, totalScore});
+    }
+
+    /// @brief Checks a pressed lane for a scored arrow.
+    /// @details Only the lowest arrow of the lane can be in the hit window, so this is O(1). A hit adds to the
+    ///          score and speeds the game up.
+    /// @param lane The lane that is pressed
+    void addPoint(Lane lane);
+
+    /// @brief Configuration the session was started with.
+    EngineConfig config;
+
+    SessionLayout layout;
+
+    /// @brief Timeline of arrow spawns, seeded from config.seed.
+    SpawnScheduler spawner;
+
+    /// @brief The authored chart arrows are spawned from, if any; replaces the spawn scheduler while set.
+    unique_ptr<ChartStream> chart;
+
+    Screen screen = SCREEN_START;
+    int totalScore = 0;
+    float speed = -1.5f;
+
+    /// @brief Tick the play screen was entered at; spawn times count from here.
+    uint32_t playStartTick = 0;
+
+    /// @brief Number of fixed simulation steps run so far.
+    uint32_t tick = 0;
+
+    /// @brief Length of one simulation step in seconds (1 / config.simRate).
+    double stepTime = 0.0;
+
+    uint8_t buttons = 0;
+    uint8_t flashLanes = 0;
+    uint8_t hitLanes = 0;
+
+    /// @brief The move per step over the ticks of play, changed on every speed up and stopped when the game ends.
+    /// @details The arrow field is moved to its distance every step, so it is the only record of how far arrows fell.
+    SpeedCurve speedCurve;
+
+    /// @brief Arrows spawned and removed during the last step, for observers that mirror the field.
+    vector<ArrowHandle> spawned, removed;
+
+    /// @brief The falling arrows.
+    ArrowField arrows;
+
+    /// @brief Per lane, the arrows that can still be hit, in the order they reach the marker.
+    LaneQueue laneQueues[LANE_COUNT];
+
+    /// @brief ArrowFlag bits of each arrow, written by checkArrows() every step.
+    vector<uint8_t> arrowFlags;
+
+    /// @brief Where session events are logged, if anywhere (not owned).
+    TelemetryWriter* telemetry = nullptr;
+};
+
+#endif //GRAPHICS_SESSION_H
@@ -0,0 +1,40 @@
+#include "spawnScheduler.h"
+
+// The spawn pattern of every second of play
+static const struct {
+    double offset;
+    SpawnRule rule;
+} PATTERN[] = {
+    {0.00, SPAWN_ALWAYS},
+    {0.25, SPAWN_FAST},
+    {0.40, SPAWN_FASTER},
+    {0.90, SPAWN_HIGH_SCORE}
+};
+
+SpawnScheduler::SpawnScheduler(uint64_t seed) {
+    reset(seed);
+}
+
+void SpawnScheduler::reset(uint64_t seed) {
+    rng.setSeed(seed);
+    events = decltype(events)();
+    nextSecond = 0;
+}
+
+bool SpawnScheduler::next(double now, SpawnEvent& event) {
+    // keep the timeline generated at least a second past now
+    while (nextSecond <= now + 1.0)
+        scheduleSecond(nextSecond++);
+
+    if (events.empty() || events.top().time > now)
+        return false;
+    event = events.top();
+    events.pop();
+    return true;
+}
+
+void SpawnScheduler::scheduleSecond(uint32_t second) {
+    // lanes are drawn for every event, spawned or not, so the lane sequence does not depend on the game state
+    for (const auto& entry : PATTERN)
+        events.push({second + entry.offset, static_cast<Lane>(rng.nextInt(LANE_COUNT)), entry.rule});
+}
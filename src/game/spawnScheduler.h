@@ -0,0 +1,78 @@
+#ifndef GRAPHICS_SPAWNSCHEDULER_H
+#define GRAPHICS_SPAWNSCHEDULER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "lane.h"
+#include "../util/random.h"
+
+using std::vector;
+
+/// @brief Condition an arrow spawn is subject to, checked when the spawn is due.
+enum SpawnRule : uint8_t {
+    /// Always spawns (the arrow every second)
+    SPAWN_ALWAYS,
+    /// Spawns once the game is fast (speed below -2.5)
+    SPAWN_FAST,
+    /// Spawns once the game is faster (speed below -3.5)
+    SPAWN_FASTER,
+    /// Spawns once the score is above 150
+    SPAWN_HIGH_SCORE
+};
+
+/// @brief An arrow spawn scheduled at a point in play time.
+struct SpawnEvent {
+    /// @brief Seconds since play started
+    double time;
+    Lane lane;
+    SpawnRule rule;
+};
+
+/**
+ * @brief Timeline of future arrow spawns
+ * @details Every second of play has the same pattern of spawn events, at offsets 0, 0.25, 0.4 and 0.9 seconds,
+ * each with a rule deciding whether it spawns. Events are generated a second ahead into a priority queue, with their
+ * lanes drawn from a seeded generator, and handed out in time order once play time reaches them. The arrows that
+ * spawn therefore depend only on the seed and the game state, not on the frame or simulation rate.
+ */
+class SpawnScheduler {
+public:
+    /// @brief Construct a new Spawn Scheduler object
+    /// @param seed Seed of the lane generator
+    explicit SpawnScheduler(uint64_t seed = 1);
+
+    /// @brief Clears the timeline and restarts it at play time 0
+    void reset(uint64_t seed);
+
+    /// @brief Pops the next event that is due
+    /// @param now Current play time in seconds
+    /// @param event Receives the event
+    /// @return false if no event is due at or before now
+    bool next(double now, SpawnEvent& event);
+
+    /// @brief Returns the state of the lane generator (used for state hashing)
+    uint64_t getRandomState() const { return rng.getState(); }
+
+    /// @brief Returns the number of generated events not handed out yet
+    size_t getPending() const { return events.size(); }
+
+private:
+    /// @brief Orders the queue so the earliest event is on top
+    struct Later {
+        bool operator()(const SpawnEvent& a, const SpawnEvent& b) const { return a.time > b.time; }
+    };
+
+    std::priority_queue<SpawnEvent, vector<SpawnEvent>, Later> events;
+    Random rng;
+
+    /// @brief First second of play whose events are not generated yet
+    uint32_t nextSecond = 0;
+
+    /// @brief Generates the events of one second of play
+    void scheduleSecond(uint32_t second);
+};
+
+#endif //GRAPHICS_SPAWNSCHEDULER_H
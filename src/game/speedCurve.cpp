@@ -0,0 +1,45 @@
+#include "speedCurve.h"
+
+#include <algorithm>
+#include <limits>
+
+SpeedCurve::SpeedCurve(size_t capacity) {
+    breakpoints.reserve(capacity);
+}
+
+void SpeedCurve::setMove(uint32_t tick, float move) {
+    if (!breakpoints.empty() && breakpoints.back().tick == tick) {
+        breakpoints.back().move = move;
+        // a replaced move can end up the same as the one before it
+        if (breakpoints.size() > 1 && breakpoints[breakpoints.size() - 2].move == move)
+            breakpoints.pop_back();
+        return;
+    }
+    if (!breakpoints.empty() && breakpoints.back().move == move)
+        return;
+    breakpoints.push_back({tick, breakpoints.empty() ? 0.0 : distanceAt(tick), move});
+}
+
+double SpeedCurve::distanceAt(double tick) const {
+    if (breakpoints.empty() || tick <= breakpoints.front().tick)
+        return 0.0;
+    // the last breakpoint at or before the tick
+    auto it = std::upper_bound(breakpoints.begin(), breakpoints.end(), tick,
+                               [](double t, const Breakpoint& breakpoint) { return t < breakpoint.tick; });
+    const Breakpoint& breakpoint = *(it - 1);
+    return breakpoint.distance + (tick - breakpoint.tick) * breakpoint.move;
+}
+
+double SpeedCurve::tickAt(double distance) const {
+    if (breakpoints.empty() || distance > 0.0)
+        return std::numeric_limits<double>::infinity();
+    // distances never increase, so the segment holding it starts at the last breakpoint that has not passed it yet
+    auto it = std::partition_point(breakpoints.begin(), breakpoints.end(),
+                                   [&](const Breakpoint& breakpoint) { return breakpoint.distance >= distance; });
+    const Breakpoint& breakpoint = *(it - 1);
+    if (breakpoint.distance == distance)
+        return breakpoint.tick;
+    if (breakpoint.move >= 0.0f)
+        return std::numeric_limits<double>::infinity();
+    return breakpoint.tick + (distance - breakpoint.distance) / breakpoint.move;
+}
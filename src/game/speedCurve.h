@@ -0,0 +1,59 @@
+#ifndef GRAPHICS_SPEEDCURVE_H
+#define GRAPHICS_SPEEDCURVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+/**
+ * @brief The distance arrows have fallen over a session, as a function of the tick
+ * @details The speed only changes between steps, so the distance is piecewise linear in the tick. The curve keeps one
+ * breakpoint per change: the tick it happened at, the distance fallen by then and the move per step from then on.
+ * The distance at any tick, and the tick a distance is reached at, are then computed directly rather than summed
+ * step by step. The session moves the arrow field to the curve's distance every step, so arrow positions between
+ * steps and hit times come from the same numbers as the steps themselves.
+ * Moves are negative (down) or 0, so the distance never increases and every distance is reached at most once.
+ */
+class SpeedCurve {
+public:
+    /// @brief Construct a new Speed Curve object
+    /// @param capacity Number of breakpoints to reserve memory for
+    explicit SpeedCurve(size_t capacity = 64);
+
+    /// @brief Removes every breakpoint; until the next setMove() nothing moves
+    void clear() { breakpoints.clear(); }
+
+    /// @brief Moves by move every step from a tick on
+    /// @details The tick must not be before the last breakpoint. Setting the same tick again replaces its move, and
+    ///          setting the move already in effect adds no breakpoint.
+    void setMove(uint32_t tick, float move);
+
+    /// @brief Returns the distance fallen by a tick (negative is down), measured from the first breakpoint
+    /// @details Fractional ticks give the distance between two steps. Ticks after the last breakpoint assume its
+    ///          move carries on; ticks before the first give 0.
+    double distanceAt(double tick) const;
+
+    /// @brief Returns the fractional tick at which the distance fallen is exactly distance
+    /// @details Distances beyond the last breakpoint assume its move carries on.
+    /// @return infinity if the distance is never reached (the curve stopped before it or is empty)
+    double tickAt(double distance) const;
+
+    /// @brief Returns the number of breakpoints
+    size_t size() const { return breakpoints.size(); }
+
+private:
+    struct Breakpoint {
+        /// @brief Tick the move changed at
+        uint32_t tick;
+        /// @brief Distance fallen by that tick
+        double distance;
+        /// @brief Distance moved by each step from that tick on
+        float move;
+    };
+
+    vector<Breakpoint> breakpoints;
+};
+
+#endif //GRAPHICS_SPEEDCURVE_H
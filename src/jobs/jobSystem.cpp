@@ -0,0 +1,160 @@
+#include "jobSystem.h"
+
+#include <algorithm>
+
+/// The job system the calling thread belongs to, and the index of its queue there.
+static thread_local const JobSystem* currentSystem = nullptr;
+static thread_local unsigned int currentQueue = 0;
+
+JobSystem::JobSystem(unsigned int threads) {
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int i = 0; i < threads; i++)
+        queues.push_back(std::make_unique<Queue>());
+
+    currentSystem = this;
+    currentQueue = 0;
+    for (unsigned int i = 1; i < threads; i++)
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+    if (currentSystem == this)
+        currentSystem = nullptr;
+}
+
+unsigned int JobSystem::queueIndex() const {
+    return currentSystem == this ? currentQueue : 0;
+}
+
+void JobSystem::submit(Job job, JobCounter* counter) {
+    job.counter = counter;
+    if (counter)
+        counter->count++;
+    notify(push(job));
+}
+
+void JobSystem::submitAfter(JobCounter& dependency, Job job, JobCounter* counter) {
+    job.counter = counter;
+    if (counter)
+        counter->count++;
+    {
+        // a job finishing the dependency releases its continuations under the same lock
+        std::lock_guard<std::mutex> lock(dependency.mutex);
+        if (dependency.count.load() > 0) {
+            dependency.continuations.push_back(job);
+            return;
+        }
+    }
+    notify(push(job));
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    unsigned int index = queueIndex();
+    while (!counter.isDone()) {
+        if (!runOne(index))
+            std::this_thread::yield();
+    }
+}
+
+bool JobSystem::push(const Job& job) {
+    Queue& queue = *queues[queueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.size < QUEUE_CAPACITY) {
+            queue.jobs[(queue.head + queue.size) % QUEUE_CAPACITY] = job;
+            queue.size++;
+            queued++;
+            return true;
+        }
+    }
+    run(job);
+    return false;
+}
+
+void JobSystem::notify(size_t jobs) {
+    if (jobs == 0 || workers.empty())
+        return;
+    // taking the lock orders the new jobs before a worker's check whether to sleep
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    if (jobs == 1)
+        wake.notify_one();
+    else
+        wake.notify_all();
+}
+
+bool JobSystem::take(unsigned int index, Job& job) {
+    {
+        Queue& own = *queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.size > 0) {
+            own.size--;
+            job = own.jobs[(own.head + own.size) % QUEUE_CAPACITY];
+            queued--;
+            return true;
+        }
+    }
+    for (size_t i = 1; i < queues.size(); i++) {
+        Queue& victim = *queues[(index + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.size > 0) {
+            job = victim.jobs[victim.head];
+            victim.head = (victim.head + 1) % QUEUE_CAPACITY;
+            victim.size--;
+            queued--;
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::run(const Job& job) {
+    job.function(job.data, job.begin, job.end);
+
+    JobCounter* counter = job.counter;
+    if (!counter)
+        return;
+    // busy keeps waiters from seeing the counter done, and destroying it, while it is still used here
+    counter->busy++;
+    vector<Job> ready;
+    if (counter->count.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(counter->mutex);
+        ready.swap(counter->continuations);
+    }
+    counter->busy--;
+
+    // the continuations are queued after letting go of the counter, so once they finished it may be gone
+    size_t released = 0;
+    for (const Job& continuation : ready)
+        released += push(continuation);
+    notify(released);
+}
+
+bool JobSystem::runOne(unsigned int index) {
+    Job job;
+    if (!take(index, job))
+        return false;
+    run(job);
+    return true;
+}
+
+void JobSystem::workerLoop(unsigned int index) {
+    currentSystem = this;
+    currentQueue = index;
+    while (true) {
+        if (runOne(index))
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [this] { return stopping.load() || queued.load() > 0; });
+        if (stopping)
+            return;
+    }
+}
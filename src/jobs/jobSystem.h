@@ -0,0 +1,177 @@
+#ifndef GRAPHICS_JOBSYSTEM_H
+#define GRAPHICS_JOBSYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using std::vector, std::unique_ptr;
+
+class JobCounter;
+
+/// @brief A unit of work: function(data, begin, end) is called on some thread of the job system.
+struct Job {
+    void (*function)(void* data, size_t begin, size_t end) = nullptr;
+    void* data = nullptr;
+    size_t begin = 0, end = 0;
+
+    /// @brief Decremented when the job finished, may be null
+    JobCounter* counter = nullptr;
+};
+
+/**
+ * @brief Counts unfinished jobs, to wait for them or to start jobs once they are done
+ * @details A counter may be reused once it is done. It must outlive the jobs counted by it and the jobs submitted
+ * after it, which JobSystem::wait() on it, or on a counter of a job submitted after it, guarantees.
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    /// @brief Returns true if every job counted has finished and the counter is no longer in use
+    bool isDone() const { return count.load() == 0 && busy.load() == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> count{0};
+
+    /// @brief Threads still finishing a job of this counter (they may release continuations)
+    std::atomic<uint32_t> busy{0};
+
+    /// @brief Jobs submitted with JobSystem::submitAfter() to run once count reaches 0
+    std::mutex mutex;
+    vector<Job> continuations;
+};
+
+/**
+ * @brief Runs jobs on a fixed set of worker threads, with per-thread queues and work stealing
+ * @details Each thread (the workers, and as queue 0 the thread that created the system) has its own queue. A
+ * thread pushes and pops jobs at the back of its own queue and, when that is empty, steals from the front of
+ * another's, so jobs stay on the thread that created them unless others run out of work. Idle workers sleep.
+ * Threads waiting for a counter run jobs meanwhile instead of blocking, so the main thread helps with its own work.
+ * Queues have a fixed capacity; a job submitted to a full queue is run right away by the submitting thread.
+ */
+class JobSystem {
+public:
+    /// @brief Jobs each queue holds
+    static constexpr size_t QUEUE_CAPACITY = 1024;
+
+    /// @brief Starts the workers
+    /// @param threads Threads running jobs including the creating thread (0 uses every core), at least 1
+    explicit JobSystem(unsigned int threads = 0);
+
+    /// @brief Stops the workers, after they finished the jobs they were running
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// @brief Returns the number of threads running jobs, including the creating thread
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(queues.size()); }
+
+    /// @brief Queues a job
+    /// @param counter Counts the job until it finished, may be null
+    void submit(Job job, JobCounter* counter);
+
+    /// @brief Queues a job once every job counted by dependency has finished
+    /// @param counter Counts the job from now until it finished, may be null
+    void submitAfter(JobCounter& dependency, Job job, JobCounter* counter);
+
+    /// @brief Runs jobs until every job counted by counter has finished
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief Calls body(begin, end) for consecutive ranges covering [0, count), in parallel
+     * @details Ranges are grain elements long (the last may be shorter), or longer if there would be more ranges
+     * than a queue holds. The calling thread runs the first range itself and helps with the others until all are
+     * done; a single range runs without involving the workers.
+     */
+    template <typename Body>
+    void parallelFor(size_t count, size_t grain, Body&& body);
+
+    /// @brief Returns the number of jobs taken from another thread's queue
+    uint64_t getSteals() const { return steals.load(); }
+
+private:
+    /// @brief A thread's jobs, a ring guarded by a lock; the owner uses the back, thieves the front
+    struct Queue {
+        std::mutex mutex;
+        Job jobs[QUEUE_CAPACITY];
+        size_t head = 0, size = 0;
+    };
+
+    vector<unique_ptr<Queue>> queues;
+    vector<std::thread> workers;
+
+    /// @brief Jobs in all queues, and what idle workers sleep on until it is not 0
+    std::atomic<uint32_t> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    std::atomic<bool> stopping{false};
+
+    std::atomic<uint64_t> steals{0};
+
+    /// @brief Returns the queue of the calling thread (queue 0 for threads outside the system)
+    unsigned int queueIndex() const;
+
+    /// @brief Puts a job in the calling thread's queue without counting it, runs it if the queue is full
+    /// @return true if queued, false if it ran
+    bool push(const Job& job);
+
+    /// @brief Wakes workers after jobs were pushed
+    void notify(size_t jobs);
+
+    /// @brief Takes a job from the back of queue index, or else from the front of another queue
+    bool take(unsigned int index, Job& job);
+
+    /// @brief Runs a job and finishes it on its counter
+    void run(const Job& job);
+
+    /// @brief Takes and runs one job
+    /// @return false if every queue was empty
+    bool runOne(unsigned int index);
+
+    void workerLoop(unsigned int index);
+};
+
+template <typename Body>
+void JobSystem::parallelFor(size_t count, size_t grain, Body&& body) {
+    using Function = std::remove_reference_t<Body>;
+    if (count == 0)
+        return;
+    // ranges that would not fit the queue get longer instead of running on this thread one by one
+    grain = std::max({grain, size_t(1), (count + QUEUE_CAPACITY - 1) / QUEUE_CAPACITY});
+    if (count <= grain || getThreadCount() == 1) {
+        body(size_t(0), count);
+        return;
+    }
+
+    JobCounter counter;
+    Job job;
+    job.function = [](void* data, size_t begin, size_t end) { (*static_cast<Function*>(data))(begin, end); };
+    job.data = const_cast<void*>(static_cast<const void*>(&body));
+    job.counter = &counter;
+    size_t pushed = 0;
+    for (size_t begin = grain; begin < count; begin += grain) {
+        job.begin = begin;
+        job.end = begin + grain < count ? begin + grain : count;
+        counter.count++;
+        pushed += push(job);
+    }
+    notify(pushed);
+
+    body(size_t(0), grain);
+    wait(counter);
+}
+
+#endif //GRAPHICS_JOBSYSTEM_H
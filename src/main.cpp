@@ -1,11 +1,271 @@
-
 #include "engine.h"
+#include "sim/botSimulator.h"
+#include "util/allocationCounter.h"
 
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
 
+/// @brief Writes every event the spawn scheduler generates in the first seconds of play to a chart file.
+/// @details Useful as a starting point for authoring and for stress testing long charts.
+static bool writeChart(const char *path, uint64_t seed, double seconds) {
+    ChartWriter writer;
+    if (!writer.open(path))
+        return false;
+    SpawnScheduler scheduler(seed);
+    SpawnEvent event;
+    while (scheduler.next(seconds, event))
+        writer.addNote(event.time, event.lane);
+    if (!writer.finish())
+        return false;
+    std::cout << "CHART: Wrote " << path << std::endl;
+    return true;
+}
+
+/// Play frames skipped by --check-allocations before measuring, while buffers grow to their working size.
+const unsigned ALLOCATION_WARMUP_FRAMES = 120;
+
+/// @brief Plays frames and counts the heap allocations each play frame makes on the main thread.
+/// @details Frames of the start and game over screens, and the first play frames, are not measured.
+/// @return true if no measured frame allocated, false otherwise
+static bool checkAllocations(Engine& engine, unsigned frames) {
+    unsigned warmup = 0, measured = 0, allocatingFrames = 0;
+    uint64_t allocations = 0, bytes = 0;
+    while (!engine.shouldClose() && measured < frames && engine.getSession().getScreen() != SCREEN_OVER) {
+        uint64_t allocationsBefore = getThreadAllocations(), bytesBefore = getThreadAllocatedBytes();
+        engine.processInput();
+        engine.update();
+        engine.render();
+        uint64_t frameAllocations = getThreadAllocations() - allocationsBefore;
+
+        if (engine.getSession().getScreen() != SCREEN_PLAY || warmup < ALLOCATION_WARMUP_FRAMES) {
+            warmup += engine.getSession().getScreen() == SCREEN_PLAY;
+            continue;
+        }
+        measured++;
+        if (frameAllocations > 0) {
+            if (allocatingFrames == 0)
+                std::cout << "ALLOCATIONS: Frame " << measured << " allocated " << frameAllocations << " times" << std::endl;
+            allocatingFrames++;
+            allocations += frameAllocations;
+            bytes += getThreadAllocatedBytes() - bytesBefore;
+        }
+    }
+    std::cout << "ALLOCATIONS: " << allocatingFrames << " of " << measured << " play frames allocated ("
+              << allocations << " allocations, " << bytes << " bytes)" << std::endl;
+    if (measured < frames)
+        std::cout << "ALLOCATIONS: The session ended before " << frames << " frames were measured" << std::endl;
+    return allocatingFrames == 0 && measured > 0;
+}
 
 int main(int argc, char *argv[]) {
-    Engine engine;
+    // Command line options:
+    //   --seed <n>       seed the spawn generator (default: clock based)
+    //   --sim-rate <hz>  fixed simulation steps per second (default: 240)
+    //   --assets <file>  asset archive to load fonts from (default: assets.pak next to the executable)
+    //   --shader-dir <dir>  read shader files from dir instead of the embedded sources, where present
+    //   --dynamic-resolution <ms>  scale the playfield resolution to keep GPU time per frame within ms
+    //   --min-resolution-scale <f> lowest playfield scale for --dynamic-resolution (default: 0.5)
+    //   --max-frames-in-flight <n>  frames the driver may queue ahead of the GPU, 1 to 8 (default: up to the driver)
+    //   --low-latency    preset for the least input lag: one frame in flight
+    //   --latency        measure keypress to frame latency, print p50/p95/p99 and a histogram per session
+    //   --particle-stress <n>  keep n particles alive and print the CPU time the particle system takes per frame
+    //   --arrow-kernel <scalar|sse2|avx2>  force an arrow kernel (default: fastest the CPU supports)
+    //   --record <file>  record the session to a replay file
+    //   --replay <file>  play a recorded session back and check it for divergence
+    //   --audio <device|null|wav:file|off>  where audio goes (default: device, null if there is none)
+    //   --audio-buffer <frames>  frames per audio buffer (default: 256)
+    //   --music <file>   16-bit PCM or float wave file played from the start of play
+    //   --publish <address>   stream the game to spectators (tcp:<host>:<port> or unix:<path>)
+    //   --spectate <address>  watch a game streamed with --publish instead of playing
+    //   --telemetry <file>  log hits, misses, press timing and score to a binary telemetry file
+    //   --chart <file>   spawn arrows from a chart file instead of the random scheduler
+    //   --write-chart <file> <seconds>  write the seeded random timeline to a chart file and exit
+    //   --autoplay       let a bot play (tuned with the --bot-* options)
+    //   --check-allocations <frames>  autoplay, fail if a steady state play frame allocates heap memory, and exit
+    //   --simulate <n>   play n headless sessions with bots on all cores, print statistics and exit
+    //   --threads <n>    worker threads for --simulate (default: one per core)
+    //   --sim-seconds <s>          stop simulated sessions after s seconds of play (default: 600)
+    //   --bot-reaction <ms>        mean bot reaction time (default: 250)
+    //   --bot-reaction-stddev <ms> standard deviation of the reaction time (default: 50)
+    //   --bot-timing <ms>          standard deviation of a bot press around the perfect moment (default: 30)
+    //   --bot-hold <ms>            how long a bot holds a press (default: one step)
+    EngineConfig config;
+    const char *recordPath = nullptr, *replayPath = nullptr, *chartPath = nullptr, *writeChartPath = nullptr,
+               *telemetryPath = nullptr, *publishAddress = nullptr, *spectateAddress = nullptr;
+    double writeChartSeconds = 0;
+    AudioConfig audio;
+    SimulatorConfig simulator;
+    // the archive is looked for next to the executable, so the game can be started from any directory
+    std::filesystem::path executableDir = std::filesystem::path(argv[0]).parent_path();
+    string assetPath = (executableDir.empty() ? std::filesystem::path("assets.pak")
+                                              : executableDir / "assets.pak").string();
+    ResolutionConfig resolution;
+    bool simulate = false, autoplay = false, dynamicResolution = false, measureLatency = false;
+    unsigned checkAllocationFrames = 0;
+    size_t particleStress = 0;
+    int maxFramesInFlight = 0;
+    bool framePacing = false;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc)
+            config.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--sim-rate") && i + 1 < argc) {
+            // text that is not entirely a number fails the check below
+            char *end;
+            config.simRate = std::strtof(argv[++i], &end);
+            if (end == argv[i] || *end != '\0')
+                config.simRate = std::nanf("");
+        }
+        else if (!strcmp(argv[i], "--assets") && i + 1 < argc)
+            assetPath = argv[++i];
+        else if (!strcmp(argv[i], "--shader-dir") && i + 1 < argc)
+            ShaderManager::setSourceDirectory(argv[++i]);
+        else if (!strcmp(argv[i], "--dynamic-resolution") && i + 1 < argc) {
+            dynamicResolution = true;
+            resolution.budgetMs = std::strtod(argv[++i], nullptr);
+        }
+        else if (!strcmp(argv[i], "--min-resolution-scale") && i + 1 < argc)
+            resolution.minScale = std::strtof(argv[++i], nullptr);
+        else if (!strcmp(argv[i], "--max-frames-in-flight") && i + 1 < argc) {
+            framePacing = true;
+            maxFramesInFlight = std::atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "--low-latency")) {
+            framePacing = true;
+            maxFramesInFlight = FramePacer::LOW_LATENCY_FRAMES;
+        }
+        else if (!strcmp(argv[i], "--latency"))
+            measureLatency = true;
+        else if (!strcmp(argv[i], "--particle-stress") && i + 1 < argc)
+            particleStress = std::strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--arrow-kernel") && i + 1 < argc) {
+            const char *name = argv[++i];
+            bool found = false;
+            for (ArrowKernel kernel : {ArrowKernel::SCALAR, ArrowKernel::SSE2, ArrowKernel::AVX2}) {
+                if (!strcmp(name, getArrowKernelName(kernel)))
+                    found = setArrowKernel(kernel);
+            }
+            if (!found)
+                std::cout << "Arrow kernel " << name << " is not available, using "
+                          << getArrowKernelName(getArrowKernel()) << std::endl;
+        }
+        else if (!strcmp(argv[i], "--record") && i + 1 < argc)
+            recordPath = argv[++i];
+        else if (!strcmp(argv[i], "--replay") && i + 1 < argc)
+            replayPath = argv[++i];
+        else if (!strcmp(argv[i], "--audio") && i + 1 < argc)
+            audio.output = argv[++i];
+        else if (!strcmp(argv[i], "--audio-buffer") && i + 1 < argc)
+            audio.bufferFrames = std::strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--music") && i + 1 < argc)
+            audio.musicPath = argv[++i];
+        else if (!strcmp(argv[i], "--publish") && i + 1 < argc)
+            publishAddress = argv[++i];
+        else if (!strcmp(argv[i], "--spectate") && i + 1 < argc)
+            spectateAddress = argv[++i];
+        else if (!strcmp(argv[i], "--telemetry") && i + 1 < argc)
+            telemetryPath = argv[++i];
+        else if (!strcmp(argv[i], "--chart") && i + 1 < argc)
+            chartPath = argv[++i];
+        else if (!strcmp(argv[i], "--write-chart") && i + 2 < argc) {
+            writeChartPath = argv[++i];
+            writeChartSeconds = std::strtod(argv[++i], nullptr);
+        }
+        else if (!strcmp(argv[i], "--autoplay"))
+            autoplay = true;
+        else if (!strcmp(argv[i], "--check-allocations") && i + 1 < argc) {
+            autoplay = true;
+            checkAllocationFrames = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (!strcmp(argv[i], "--simulate") && i + 1 < argc) {
+            simulate = true;
+            simulator.sessions = std::strtoul(argv[++i], nullptr, 10);
+        }
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+            simulator.threads = std::strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--sim-seconds") && i + 1 < argc)
+            simulator.maxSeconds = std::strtod(argv[++i], nullptr);
+        else if (!strcmp(argv[i], "--bot-reaction") && i + 1 < argc)
+            simulator.bot.reactionMean = std::strtod(argv[++i], nullptr) / 1000;
+        else if (!strcmp(argv[i], "--bot-reaction-stddev") && i + 1 < argc)
+            simulator.bot.reactionStdDev = std::strtod(argv[++i], nullptr) / 1000;
+        else if (!strcmp(argv[i], "--bot-timing") && i + 1 < argc)
+            simulator.bot.timingStdDev = std::strtod(argv[++i], nullptr) / 1000;
+        else if (!strcmp(argv[i], "--bot-hold") && i + 1 < argc)
+            simulator.bot.holdTime = std::strtod(argv[++i], nullptr) / 1000;
+        else
+            std::cout << "Ignoring unknown argument " << argv[i] << std::endl;
+    }
+
+    if (audio.bufferFrames == 0) {
+        std::cout << "ERROR::ARGS: --audio-buffer must be positive" << std::endl;
+        return -1;
+    }
+    if (dynamicResolution && resolution.budgetMs <= 0) {
+        std::cout << "ERROR::ARGS: --dynamic-resolution must be positive" << std::endl;
+        return -1;
+    }
+    if (framePacing && (maxFramesInFlight < 1 || maxFramesInFlight > FramePacer::MAX_FRAMES_IN_FLIGHT)) {
+        std::cout << "ERROR::ARGS: --max-frames-in-flight must be between 1 and "
+                  << FramePacer::MAX_FRAMES_IN_FLIGHT << std::endl;
+        return -1;
+    }
+    if (!EngineConfig::isValidSimRate(config.simRate)) {
+        std::cout << "ERROR::ARGS: --sim-rate must be a number above 0 and at most " << EngineConfig::MAX_SIM_RATE
+                  << " steps per second" << std::endl;
+        return -1;
+    }
+
+    if (writeChartPath)
+        return writeChart(writeChartPath, config.seed, writeChartSeconds) ? 0 : -1;
+
+    if (simulate) {
+        // simulations are reproducible by default, a seed still picks a different set of sessions
+        simulator.engine = config;
+        if (simulator.engine.seed == 0)
+            simulator.engine.seed = 1;
+        if (chartPath)
+            simulator.chartPath = chartPath;
+        BotSimulator bots(simulator);
+        if (!bots.run())
+            return -1;
+        bots.report();
+        return 0;
+    }
+
+    Engine engine(config, assetPath);
+    if (chartPath && !engine.loadChart(chartPath))
+        return -1;
+    if (replayPath && !engine.startPlayback(replayPath))
+        return -1;
+    if (recordPath)
+        engine.startRecording(recordPath);
+    if (telemetryPath && !engine.startTelemetry(telemetryPath))
+        return -1;
+    if (publishAddress && !engine.startPublishing(publishAddress))
+        return -1;
+    if (spectateAddress && !engine.startSpectating(spectateAddress))
+        return -1;
+    if (audio.output != "off" && !spectateAddress)
+        engine.startAudio(audio);
+    if (dynamicResolution && !engine.startDynamicResolution(resolution))
+        return -1;
+    if (framePacing)
+        engine.startFramePacing(maxFramesInFlight);
+    if (measureLatency && !spectateAddress)
+        engine.startLatencyMonitor();
+    if (particleStress > 0)
+        engine.startParticleStress(particleStress);
+    if (autoplay && !replayPath && !spectateAddress)
+        engine.startAutoplay(simulator.bot, engine.getSession().getConfig().seed);
+
+    if (checkAllocationFrames > 0) {
+        bool clean = checkAllocations(engine, checkAllocationFrames);
+        glfwTerminate();
+        return clean ? 0 : 1;
+    }
 
     while (!engine.shouldClose()) {
         engine.processInput();
@@ -0,0 +1,234 @@
+#include "socket.h"
+
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET NativeSocket;
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+typedef int NativeSocket;
+#endif
+
+using std::cout, std::endl;
+
+static const NativeSocket NO_SOCKET = static_cast<NativeSocket>(-1);
+
+#ifdef _WIN32
+/// Starts Winsock on first use
+static bool initSockets() {
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+static bool wouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+static void closeNative(NativeSocket s) { closesocket(s); }
+#else
+static bool initSockets() { return true; }
+static bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR; }
+static void closeNative(NativeSocket s) { ::close(s); }
+#endif
+
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL; // a closed peer is an error return, not SIGPIPE
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+/// The parts of an address string
+struct Address {
+    bool tcp;
+    string host, port, path;
+};
+
+static bool parseAddress(const string& text, Address& address) {
+    if (text.compare(0, 4, "tcp:") == 0) {
+        size_t colon = text.rfind(':');
+        if (colon <= 4) return false;
+        address = {true, text.substr(4, colon - 4), text.substr(colon + 1), ""};
+        return !address.port.empty();
+    }
+    if (text.compare(0, 5, "unix:") == 0 && text.size() > 5) {
+#ifdef _WIN32
+        cout << "ERROR::SOCKET: Unix sockets are not supported on this platform" << endl;
+        return false;
+#else
+        address = {false, "", "", text.substr(5)};
+        return address.path.size() < sizeof(sockaddr_un::sun_path);
+#endif
+    }
+    return false;
+}
+
+/// Creates a socket for an address and binds (listening) or connects it
+static NativeSocket openSocket(const Address& address, bool listening) {
+    NativeSocket s = NO_SOCKET;
+    if (address.tcp) {
+        addrinfo hints = {}, *results = nullptr;
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = listening ? AI_PASSIVE : 0;
+        if (getaddrinfo(address.host.c_str(), address.port.c_str(), &hints, &results) != 0)
+            return s;
+        for (addrinfo* at = results; at; at = at->ai_next) {
+            s = socket(at->ai_family, at->ai_socktype, at->ai_protocol);
+            if (s == NO_SOCKET)
+                continue;
+            if (listening) {
+                int yes = 1;
+                setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&yes), sizeof(yes));
+                if (bind(s, at->ai_addr, static_cast<int>(at->ai_addrlen)) == 0 && ::listen(s, 8) == 0)
+                    break;
+            } else if (::connect(s, at->ai_addr, static_cast<int>(at->ai_addrlen)) == 0) {
+                break;
+            }
+            closeNative(s);
+            s = NO_SOCKET;
+        }
+        freeaddrinfo(results);
+        return s;
+    }
+
+#ifndef _WIN32
+    sockaddr_un unixAddress = {};
+    unixAddress.sun_family = AF_UNIX;
+    std::strncpy(unixAddress.sun_path, address.path.c_str(), sizeof(unixAddress.sun_path) - 1);
+    s = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s == NO_SOCKET)
+        return s;
+    if (listening) {
+        unlink(address.path.c_str()); // a stale socket file from a crashed run would block the bind
+        if (bind(s, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) == 0 && ::listen(s, 8) == 0)
+            return s;
+    } else if (::connect(s, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) == 0) {
+        return s;
+    }
+    closeNative(s);
+#endif
+    return NO_SOCKET;
+}
+
+Socket::~Socket() {
+    close();
+}
+
+Socket::Socket(Socket&& other) noexcept : handle(other.handle), unixPath(std::move(other.unixPath)) {
+    other.handle = INVALID;
+    other.unixPath.clear();
+}
+
+Socket& Socket::operator=(Socket&& other) noexcept {
+    if (this != &other) {
+        close();
+        handle = other.handle;
+        unixPath = std::move(other.unixPath);
+        other.handle = INVALID;
+        other.unixPath.clear();
+    }
+    return *this;
+}
+
+bool Socket::listen(const string& address) {
+    close();
+    Address parsed;
+    if (!initSockets() || !parseAddress(address, parsed)) {
+        cout << "ERROR::SOCKET: Invalid address " << address << " (use tcp:<host>:<port> or unix:<path>)" << endl;
+        return false;
+    }
+    NativeSocket s = openSocket(parsed, true);
+    if (s == NO_SOCKET) {
+        cout << "ERROR::SOCKET: Could not listen on " << address << endl;
+        return false;
+    }
+    handle = static_cast<intptr_t>(s);
+    unixPath = parsed.path;
+    configure(false);
+    return true;
+}
+
+bool Socket::connect(const string& address) {
+    close();
+    Address parsed;
+    if (!initSockets() || !parseAddress(address, parsed)) {
+        cout << "ERROR::SOCKET: Invalid address " << address << " (use tcp:<host>:<port> or unix:<path>)" << endl;
+        return false;
+    }
+    NativeSocket s = openSocket(parsed, false);
+    if (s == NO_SOCKET) {
+        cout << "ERROR::SOCKET: Could not connect to " << address << endl;
+        return false;
+    }
+    handle = static_cast<intptr_t>(s);
+    configure(parsed.tcp);
+    return true;
+}
+
+bool Socket::accept(Socket& client) {
+    NativeSocket s = ::accept(static_cast<NativeSocket>(handle), nullptr, nullptr);
+    if (s == NO_SOCKET)
+        return false;
+    client.close();
+    client.handle = static_cast<intptr_t>(s);
+    client.configure(unixPath.empty());
+    return true;
+}
+
+long Socket::send(const void* data, size_t size) {
+    auto sent = ::send(static_cast<NativeSocket>(handle), static_cast<const char*>(data), static_cast<int>(size),
+                       SEND_FLAGS);
+    if (sent < 0)
+        return wouldBlock() ? 0 : -1;
+    return static_cast<long>(sent);
+}
+
+long Socket::receive(void* data, size_t size) {
+    auto received = ::recv(static_cast<NativeSocket>(handle), static_cast<char*>(data), static_cast<int>(size), 0);
+    if (received < 0)
+        return wouldBlock() ? 0 : -1;
+    if (received == 0)
+        return -1; // orderly shutdown by the peer
+    return static_cast<long>(received);
+}
+
+void Socket::close() {
+    if (handle == INVALID)
+        return;
+    closeNative(static_cast<NativeSocket>(handle));
+    handle = INVALID;
+#ifndef _WIN32
+    if (!unixPath.empty())
+        unlink(unixPath.c_str());
+#endif
+    unixPath.clear();
+}
+
+void Socket::configure(bool tcp) {
+    NativeSocket s = static_cast<NativeSocket>(handle);
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    ioctlsocket(s, FIONBIO, &nonBlocking);
+#else
+    fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+    int noSigPipe = 1;
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+#endif
+#endif
+    if (tcp) {
+        int noDelay = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef GRAPHICS_SOCKET_H
+#define GRAPHICS_SOCKET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+using std::string;
+
+/**
+ * @brief A non-blocking stream socket (TCP or Unix domain)
+ * @details Addresses are written "tcp:<host>:<port>" or "unix:<path>". Once connected or accepted, sends and
+ * receives never block: they report how much was transferred, and 0 when the call would have blocked.
+ */
+class Socket {
+public:
+    Socket() = default;
+    ~Socket();
+    Socket(Socket&& other) noexcept;
+    Socket& operator=(Socket&& other) noexcept;
+    Socket(const Socket&) = delete;
+    Socket& operator=(const Socket&) = delete;
+
+    /// @brief Starts listening for connections on an address
+    /// @return true if listening, false otherwise
+    bool listen(const string& address);
+
+    /// @brief Connects to a listening address (blocks until connected)
+    /// @return true if connected, false otherwise
+    bool connect(const string& address);
+
+    /// @brief Accepts a pending connection, if there is one (listening sockets only)
+    /// @return true if a client was accepted into client
+    bool accept(Socket& client);
+
+    /// @brief Sends as much of the data as the socket takes right now
+    /// @return the number of bytes sent (0 if it would block), or -1 if the connection is gone
+    long send(const void* data, size_t size);
+
+    /// @brief Receives whatever data is available right now
+    /// @return the number of bytes received (0 if none), or -1 if the connection is closed
+    long receive(void* data, size_t size);
+
+    /// @brief Closes the socket (and removes the file of a listening Unix socket)
+    void close();
+
+    bool isOpen() const { return handle != INVALID; }
+
+private:
+    /// @brief Makes the socket non-blocking and turns off Nagle's algorithm for TCP
+    void configure(bool tcp);
+
+    static constexpr intptr_t INVALID = -1;
+    intptr_t handle = INVALID;
+    string unixPath;
+};
+
+#endif //GRAPHICS_SOCKET_H
@@ -0,0 +1,285 @@
+#include "spectator.h"
+#include "../util/binaryIO.h"
+
+#include <iostream>
+
+using std::cout, std::endl;
+
+// Payloads, after the u32 length. Integers are varints, floats are f32, the field's distances f64.
+//   KEYFRAME: type, tick, u8 screen, score, u8 buttons, u8 flash lanes, origin, distance, arrow count,
+//             arrows {id, u8 lane, base}
+//   DELTA:    type, tick, u8 screen, score, u8 buttons, u8 flash lanes, distance,
+//             spawn count, spawns {id, u8 lane, base}, removal count, removals {id}
+// An arrow's id is its handle in the publisher's field, (generation << 32) | slot. Its y is base + distance - origin.
+enum MessageType : uint8_t { MESSAGE_KEYFRAME = 1, MESSAGE_DELTA = 2 };
+
+/// Most bytes queued for one spectator before it is dropped
+static const size_t MAX_PENDING = 4 * 1024 * 1024;
+
+/// New spectators are let in every this many steps
+static const uint32_t ACCEPT_INTERVAL = 16;
+
+/// Largest message a spectator accepts
+static const uint32_t MAX_MESSAGE = 64 * 1024 * 1024;
+
+static uint64_t arrowId(ArrowHandle handle) {
+    return (static_cast<uint64_t>(handle.generation) << 32) | handle.slot;
+}
+
+/// Writes the fields every message starts with
+static void beginMessage(vector<uint8_t>& out, MessageType type, const Session& session) {
+    out.clear();
+    appendLE<uint32_t>(out, 0); // length, filled in by endMessage()
+    out.push_back(type);
+    appendVarint(out, session.getTick());
+    out.push_back(static_cast<uint8_t>(session.getScreen()));
+    appendVarint(out, static_cast<uint32_t>(session.getScore()));
+    out.push_back(session.getButtons());
+    out.push_back(session.getFlashLanes());
+}
+
+static void endMessage(vector<uint8_t>& out) {
+    uint32_t length = static_cast<uint32_t>(out.size() - 4);
+    for (int i = 0; i < 4; i++)
+        out[i] = static_cast<uint8_t>(length >> (8 * i));
+}
+
+// --------------------------------------------------------
+// SpectatorPublisher
+// --------------------------------------------------------
+
+bool SpectatorPublisher::open(const string& address) {
+    if (!listener.listen(address))
+        return false;
+    cout << "SPECTATOR: Publishing on " << address << endl;
+    return true;
+}
+
+void SpectatorPublisher::publish(const Session& session) {
+    // a session that did not just advance by one step (a restart) is resent in full
+    bool continuous = session.getTick() == lastTick + 1;
+    lastTick = session.getTick();
+
+    if (!clients.empty()) {
+        if (continuous)
+            encodeDelta(session, message);
+        else
+            encodeKeyframe(session, message);
+        for (size_t i = clients.size(); i-- > 0;) {
+            if (!send(clients[i], message)) {
+                cout << "SPECTATOR: Dropped a spectator" << endl;
+                clients.erase(clients.begin() + i);
+            }
+        }
+    }
+
+    // accepting is a system call, so new spectators are only looked for every few steps
+    if (publishCount++ % ACCEPT_INTERVAL != 0)
+        return;
+    Client client;
+    while (listener.accept(client.socket)) {
+        encodeKeyframe(session, message);
+        if (send(client, message)) {
+            cout << "SPECTATOR: Spectator joined (" << clients.size() + 1 << " watching)" << endl;
+            clients.push_back(std::move(client));
+        }
+        client = Client();
+    }
+}
+
+void SpectatorPublisher::encodeKeyframe(const Session& session, vector<uint8_t>& out) const {
+    const ArrowField& arrows = session.getArrows();
+    beginMessage(out, MESSAGE_KEYFRAME, session);
+    appendLE<double>(out, arrows.getOrigin());
+    appendLE<double>(out, arrows.getDistance());
+    appendVarint(out, arrows.size());
+    for (size_t i = 0; i < arrows.size(); i++) {
+        appendVarint(out, arrowId(arrows.handleAt(i)));
+        out.push_back(arrows.getLane()[i]);
+        appendLE<float>(out, arrows.getBase()[i]);
+    }
+    endMessage(out);
+}
+
+void SpectatorPublisher::encodeDelta(const Session& session, vector<uint8_t>& out) const {
+    const ArrowField& arrows = session.getArrows();
+    beginMessage(out, MESSAGE_DELTA, session);
+    appendLE<double>(out, arrows.getDistance());
+
+    // arrows spawned and removed in the same step never reach the spectator
+    size_t spawnCount = 0;
+    for (ArrowHandle handle : session.getSpawned())
+        spawnCount += arrows.isValid(handle);
+    appendVarint(out, spawnCount);
+    for (ArrowHandle handle : session.getSpawned()) {
+        if (!arrows.isValid(handle))
+            continue;
+        size_t i = arrows.indexOf(handle);
+        appendVarint(out, arrowId(handle));
+        out.push_back(arrows.getLane()[i]);
+        appendLE<float>(out, arrows.getBase()[i]);
+    }
+
+    appendVarint(out, session.getRemoved().size());
+    for (ArrowHandle handle : session.getRemoved())
+        appendVarint(out, arrowId(handle));
+    endMessage(out);
+}
+
+bool SpectatorPublisher::send(Client& client, const vector<uint8_t>& message) {
+    // keep the stream in order: nothing new goes out directly while older data is still queued
+    if (client.pending.empty()) {
+        long sent = client.socket.send(message.data(), message.size());
+        if (sent < 0)
+            return false;
+        client.pending.insert(client.pending.end(), message.begin() + sent, message.end());
+        return true;
+    }
+
+    client.pending.insert(client.pending.end(), message.begin(), message.end());
+    long sent = client.socket.send(client.pending.data(), client.pending.size());
+    if (sent < 0)
+        return false;
+    client.pending.erase(client.pending.begin(), client.pending.begin() + sent);
+    return client.pending.size() <= MAX_PENDING;
+}
+
+// --------------------------------------------------------
+// SpectatorClient
+// --------------------------------------------------------
+
+bool SpectatorClient::connect(const string& address) {
+    if (!socket.connect(address))
+        return false;
+    cout << "SPECTATOR: Watching " << address << endl;
+    return true;
+}
+
+bool SpectatorClient::poll() {
+    if (!socket.isOpen())
+        return false;
+
+    uint8_t chunk[16384];
+    long count;
+    while ((count = socket.receive(chunk, sizeof(chunk))) > 0)
+        received.insert(received.end(), chunk, chunk + count);
+
+    // apply every complete message
+    size_t at = 0;
+    while (received.size() - at >= 4) {
+        uint32_t length = loadLE<uint32_t>(received.data() + at);
+        if (length > MAX_MESSAGE) {
+            cout << "ERROR::SPECTATOR: Message of " << length << " bytes is too large" << endl;
+            socket.close();
+            return false;
+        }
+        if (received.size() - at - 4 < length)
+            break;
+        const uint8_t* payload = received.data() + at + 4;
+        if (!apply(payload, payload + length)) {
+            cout << "ERROR::SPECTATOR: Malformed message at tick " << tick << endl;
+            socket.close();
+            return false;
+        }
+        at += 4 + length;
+    }
+    received.erase(received.begin(), received.begin() + at);
+
+    if (count < 0) {
+        cout << "SPECTATOR: The game has ended the stream" << endl;
+        socket.close();
+        return false;
+    }
+    return true;
+}
+
+void SpectatorClient::addArrow(uint64_t id, uint8_t lane, float base) {
+    if (lane >= LANE_COUNT)
+        return;
+    // the base is taken over as is, so y = base + travel rounds exactly like the publisher's
+    ArrowHandle handle = arrows.spawn(layout.laneX[lane], 0.0f, lane, 0.0f);
+    arrows.getBase()[arrows.indexOf(handle)] = base;
+    ids[id] = handle;
+}
+
+bool SpectatorClient::apply(const uint8_t* data, const uint8_t* end) {
+    uint64_t value;
+    auto readByte = [&](uint8_t& out) {
+        if (data >= end) return false;
+        out = *data++;
+        return true;
+    };
+    auto readFloat = [&](float& out) {
+        if (end - data < 4) return false;
+        out = loadLE<float>(data);
+        data += 4;
+        return true;
+    };
+    auto readDouble = [&](double& out) {
+        if (end - data < 8) return false;
+        out = loadLE<double>(data);
+        data += 8;
+        return true;
+    };
+
+    uint8_t type, screenByte;
+    uint64_t tickValue, scoreValue;
+    if (!readByte(type) || !decodeVarint(data, end, tickValue) || !readByte(screenByte) ||
+        !decodeVarint(data, end, scoreValue) || !readByte(buttons) || !readByte(flashLanes) ||
+        screenByte > SCREEN_OVER)
+        return false;
+    tick = static_cast<uint32_t>(tickValue);
+    screen = static_cast<Screen>(screenByte);
+    score = static_cast<int>(scoreValue);
+
+    if (type == MESSAGE_KEYFRAME) {
+        arrows.clear();
+        ids.clear();
+        double origin, distance;
+        uint64_t count;
+        if (!readDouble(origin) || !readDouble(distance) || !decodeVarint(data, end, count))
+            return false;
+        arrows.setDistance(origin, distance);
+        for (uint64_t i = 0; i < count; i++) {
+            uint8_t lane;
+            float base;
+            if (!decodeVarint(data, end, value) || !readByte(lane) || !readFloat(base))
+                return false;
+            addArrow(value, lane, base);
+        }
+        return data == end;
+    }
+    if (type != MESSAGE_DELTA)
+        return false;
+
+    // every arrow moved to the same distance this step, set exactly as the simulation set it
+    double distance;
+    if (!readDouble(distance))
+        return false;
+    arrows.moveTo(distance);
+
+    uint64_t count;
+    if (!decodeVarint(data, end, count))
+        return false;
+    for (uint64_t i = 0; i < count; i++) {
+        uint8_t lane;
+        float base;
+        if (!decodeVarint(data, end, value) || !readByte(lane) || !readFloat(base))
+            return false;
+        addArrow(value, lane, base);
+    }
+
+    if (!decodeVarint(data, end, count))
+        return false;
+    for (uint64_t i = 0; i < count; i++) {
+        if (!decodeVarint(data, end, value))
+            return false;
+        auto found = ids.find(value);
+        if (found == ids.end())
+            continue;
+        if (arrows.isValid(found->second))
+            arrows.remove(arrows.indexOf(found->second));
+        ids.erase(found);
+    }
+    return data == end;
+}
@@ -0,0 +1,98 @@
+#ifndef GRAPHICS_SPECTATOR_H
+#define GRAPHICS_SPECTATOR_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "socket.h"
+#include "../game/session.h"
+
+using std::string, std::vector;
+
+/**
+ * @brief Streams a live session to spectators
+ * @details Every step is sent as a delta: the screen, score and held buttons, the distance all arrows fell to, and the
+ * arrows spawned and removed. Arrows all move by the same distance, so positions never have to be resent, and a
+ * step with nothing new costs about 19 bytes. A spectator that connects gets one keyframe with every arrow, then
+ * deltas. Sockets are non-blocking; a spectator that cannot keep up has its data queued up to a limit and is then
+ * disconnected, so a slow viewer never stalls the game.
+ *
+ * Messages are a u32 payload length followed by the payload; see spectator.cpp for the payloads.
+ */
+class SpectatorPublisher {
+public:
+    /// @brief Starts listening for spectators
+    /// @param address "tcp:<host>:<port>" or "unix:<path>"
+    /// @return true if listening, false otherwise
+    bool open(const string& address);
+
+    /// @brief Sends the last step of the session to every spectator, and lets new spectators in
+    void publish(const Session& session);
+
+    size_t getClientCount() const { return clients.size(); }
+
+private:
+    struct Client {
+        Socket socket;
+        vector<uint8_t> pending;
+    };
+
+    void encodeKeyframe(const Session& session, vector<uint8_t>& out) const;
+    void encodeDelta(const Session& session, vector<uint8_t>& out) const;
+
+    /// @brief Sends a message to a client, queueing what the socket does not take
+    /// @return false if the client is gone or too far behind
+    bool send(Client& client, const vector<uint8_t>& message);
+
+    Socket listener;
+    vector<Client> clients;
+    vector<uint8_t> message;
+    uint32_t lastTick = 0;
+    uint32_t publishCount = 0;
+};
+
+/**
+ * @brief Mirrors a session streamed by a SpectatorPublisher
+ * @details Applies the keyframe and deltas to its own arrow field, moving it to each step's distance with the same
+ * arithmetic as the simulation (keyframes carry the origin and distance, arrows their base), so the mirrored arrows
+ * match the player's exactly.
+ */
+class SpectatorClient {
+public:
+    /// @brief Connects to a publisher
+    /// @return true if connected, false otherwise
+    bool connect(const string& address);
+
+    /// @brief Applies every message received since the last call
+    /// @return false once the publisher has gone away
+    bool poll();
+
+    const ArrowField& getArrows() const { return arrows; }
+    Screen getScreen() const { return screen; }
+    int getScore() const { return score; }
+    uint8_t getButtons() const { return buttons; }
+    uint8_t getFlashLanes() const { return flashLanes; }
+    uint32_t getTick() const { return tick; }
+
+private:
+    /// @brief Applies one message payload
+    /// @return false if it is malformed
+    bool apply(const uint8_t* data, const uint8_t* end);
+
+    /// @brief Adds an arrow under the publisher's id
+    void addArrow(uint64_t id, uint8_t lane, float base);
+
+    Socket socket;
+    vector<uint8_t> received;
+    SessionLayout layout;
+    ArrowField arrows;
+    std::unordered_map<uint64_t, ArrowHandle> ids;
+    Screen screen = SCREEN_START;
+    int score = 0;
+    uint8_t buttons = 0, flashLanes = 0;
+    uint32_t tick = 0;
+};
+
+#endif //GRAPHICS_SPECTATOR_H
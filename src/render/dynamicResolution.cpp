@@ -0,0 +1,94 @@
+#include "dynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+/// Measurements averaged before the scale may change again
+static const int SETTLE_SAMPLES = 8;
+
+/// Weight of a new measurement in the moving average
+static const double AVERAGE_WEIGHT = 0.25;
+
+/// Below this fraction of the budget the scale is raised
+static const double HEADROOM = 0.7;
+
+/// Step the scale is raised by, and the smallest change worth making
+static const float STEP_UP = 0.05f, MIN_CHANGE = 0.02f;
+
+DynamicResolution::DynamicResolution(int width, int height, const ResolutionConfig& config)
+    : width(width), height(height), config(config) {
+    this->config.minScale = std::clamp(config.minScale, 0.1f, 1.0f);
+
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+        std::cout << "ERROR::RESOLUTION: Could not create the offscreen playfield target" << std::endl;
+}
+
+DynamicResolution::~DynamicResolution() {
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &colorTexture);
+}
+
+void DynamicResolution::beginFrame() {
+    timer.begin();
+}
+
+void DynamicResolution::beginPlayfield() {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, scaledWidth(), scaledHeight());
+    glClear(GL_COLOR_BUFFER_BIT); // with the clear color of the window
+}
+
+void DynamicResolution::endPlayfield() {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, scaledWidth(), scaledHeight(), 0, 0, width, height, GL_COLOR_BUFFER_BIT,
+                      scale < 1.0f ? GL_LINEAR : GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, width, height);
+}
+
+void DynamicResolution::endFrame() {
+    timer.end();
+
+    double ms;
+    if (!timer.poll(ms))
+        return;
+    averageMs = samples == 0 ? ms : averageMs + (ms - averageMs) * AVERAGE_WEIGHT;
+    if (++samples < SETTLE_SAMPLES)
+        return;
+
+    float target = scale;
+    if (averageMs > config.budgetMs)
+        target = scale * static_cast<float>(std::sqrt(config.budgetMs / averageMs));
+    else if (averageMs < config.budgetMs * HEADROOM)
+        target = scale + STEP_UP;
+    target = std::clamp(target, config.minScale, 1.0f);
+
+    if (std::fabs(target - scale) >= MIN_CHANGE || (target == 1.0f && scale != 1.0f)) {
+        std::cout << "RESOLUTION: Playfield at " << static_cast<int>(target * 100 + 0.5f) << "% (GPU frame "
+                  << averageMs << " ms, budget " << config.budgetMs << " ms)" << std::endl;
+        scale = target;
+        samples = 0;
+    }
+}
+
+int DynamicResolution::scaledWidth() const {
+    return std::max(1, static_cast<int>(std::lround(width * scale)));
+}
+
+int DynamicResolution::scaledHeight() const {
+    return std::max(1, static_cast<int>(std::lround(height * scale)));
+}
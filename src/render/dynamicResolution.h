@@ -0,0 +1,79 @@
+#ifndef GRAPHICS_DYNAMICRESOLUTION_H
+#define GRAPHICS_DYNAMICRESOLUTION_H
+
+#include <glad/glad.h>
+
+#include "gpuTimer.h"
+
+/// @brief How the playfield resolution follows the GPU frame time
+struct ResolutionConfig {
+    /// @brief GPU time per frame to stay within, in milliseconds
+    double budgetMs = 4.0;
+
+    /// @brief Lowest fraction of the window resolution the playfield is rendered at
+    float minScale = 0.5f;
+};
+
+/**
+ * @brief Renders the playfield at a resolution that scales with the GPU load
+ * @details Between beginPlayfield() and endPlayfield(), drawing goes to an offscreen target the size of the
+ * window, of which only scale x scale is used; endPlayfield() stretches that part over the window. The projection
+ * does not change, since the viewport shrinks with the target. Everything drawn after endPlayfield() (the HUD and
+ * text) is drawn at native resolution on top.
+ *
+ * The GPU time of whole frames is measured with timestamp queries. When its average exceeds the budget, the scale
+ * drops in proportion to the square root of the overshoot (fill cost grows with the area); with plenty of headroom
+ * it rises again in small steps. The scale only moves once a few new measurements came in since the last change,
+ * so the controller does not chase its own lag.
+ */
+class DynamicResolution {
+public:
+    /// @brief Creates the offscreen target (needs a current OpenGL context)
+    /// @param width Width of the window in pixels
+    /// @param height Height of the window in pixels
+    DynamicResolution(int width, int height, const ResolutionConfig& config);
+
+    /// @brief Deletes the offscreen target
+    ~DynamicResolution();
+
+    DynamicResolution(const DynamicResolution&) = delete;
+    DynamicResolution& operator=(const DynamicResolution&) = delete;
+
+    /// @brief Returns true if the offscreen target could be created
+    bool isComplete() const { return complete; }
+
+    /// @brief Starts measuring a frame, call before anything is drawn
+    void beginFrame();
+
+    /// @brief Redirects drawing to the offscreen target at the current scale and clears it
+    void beginPlayfield();
+
+    /// @brief Stretches the playfield over the window and restores drawing to it
+    void endPlayfield();
+
+    /// @brief Stops measuring the frame and adapts the scale, call after everything is drawn
+    void endFrame();
+
+    /// @brief Returns the fraction of the window resolution the playfield is rendered at
+    float getScale() const { return scale; }
+
+private:
+    int width, height;
+    ResolutionConfig config;
+
+    GLuint framebuffer = 0, colorTexture = 0;
+    bool complete = false;
+
+    GpuTimer timer;
+    float scale = 1.0f;
+
+    /// @brief Moving average of the frame GPU time, and measurements averaged since the last scale change
+    double averageMs = 0.0;
+    int samples = 0;
+
+    /// @brief Size of the used part of the target
+    int scaledWidth() const;
+    int scaledHeight() const;
+};
+
+#endif //GRAPHICS_DYNAMICRESOLUTION_H
@@ -0,0 +1,52 @@
+#include "framePacer.h"
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <iostream>
+
+/// Longest single wait for a fence in nanoseconds; waiting goes on after it, but a lost context cannot hang us.
+static const GLuint64 WAIT_TIMEOUT = 100000000;
+
+FramePacer::FramePacer(int maxFramesInFlight)
+    : maxFramesInFlight(std::clamp(maxFramesInFlight, 1, MAX_FRAMES_IN_FLIGHT)) {}
+
+FramePacer::~FramePacer() {
+    for (GLsync fence : fences) {
+        if (fence)
+            glDeleteSync(fence);
+    }
+}
+
+void FramePacer::waitForFrame() {
+    GLsync fence = fences[next];
+    if (!fence)
+        return;
+    frames++;
+
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        double start = glfwGetTime();
+        do
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT);
+        while (status == GL_TIMEOUT_EXPIRED);
+        waitedSeconds += glfwGetTime() - start;
+        waitedFrames++;
+    }
+    glDeleteSync(fence);
+    fences[next] = nullptr;
+}
+
+void FramePacer::endFrame() {
+    if (fences[next])
+        glDeleteSync(fences[next]);
+    fences[next] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    next = (next + 1) % maxFramesInFlight;
+}
+
+void FramePacer::report() const {
+    std::cout << "FRAMES: " << waitedFrames << " of " << frames << " frames waited for the GPU to stay within "
+              << maxFramesInFlight << " frame" << (maxFramesInFlight == 1 ? "" : "s") << " in flight";
+    if (waitedFrames > 0)
+        std::cout << ", " << waitedSeconds * 1000.0 / static_cast<double>(waitedFrames) << " ms on average";
+    std::cout << std::endl;
+}
@@ -0,0 +1,55 @@
+#ifndef GRAPHICS_FRAMEPACER_H
+#define GRAPHICS_FRAMEPACER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+
+/**
+ * @brief Limits how many frames the driver may queue ahead of the GPU
+ * @details Drivers let the CPU run several frames ahead behind the swap, and every queued frame delays when input
+ * read now reaches the screen. endFrame() puts a fence behind each swap; waitForFrame() blocks until the fence of
+ * the frame maxFramesInFlight frames back has signaled, so input and simulation of the next frame only start
+ * once fewer than maxFramesInFlight frames are queued. With 1 the CPU never runs ahead of the GPU, which gives the
+ * lowest latency at the cost of the overlap between CPU and GPU work.
+ */
+class FramePacer {
+public:
+    /// @brief Highest supported limit
+    static constexpr int MAX_FRAMES_IN_FLIGHT = 8;
+
+    /// @brief Limit of the low latency preset
+    static constexpr int LOW_LATENCY_FRAMES = 1;
+
+    /// @param maxFramesInFlight Frames that may be queued, 1 to MAX_FRAMES_IN_FLIGHT
+    explicit FramePacer(int maxFramesInFlight);
+
+    /// @brief Deletes the pending fences
+    ~FramePacer();
+
+    FramePacer(const FramePacer&) = delete;
+    FramePacer& operator=(const FramePacer&) = delete;
+
+    /// @brief Waits until a new frame may start, call before reading input
+    void waitForFrame();
+
+    /// @brief Marks the end of a frame, call right after its swap
+    void endFrame();
+
+    /// @brief Returns the limit in use
+    int getMaxFramesInFlight() const { return maxFramesInFlight; }
+
+    /// @brief Prints how many frames had to wait and how long they waited on average
+    void report() const;
+
+private:
+    int maxFramesInFlight;
+
+    /// @brief Fence per frame in flight, next is where the coming endFrame() puts its fence
+    GLsync fences[MAX_FRAMES_IN_FLIGHT] = {};
+    int next = 0;
+
+    uint64_t frames = 0, waitedFrames = 0;
+    double waitedSeconds = 0.0;
+};
+
+#endif //GRAPHICS_FRAMEPACER_H
@@ -0,0 +1,46 @@
+#include "gpuTimer.h"
+
+GpuTimer::GpuTimer() {
+    glGenQueries(RING_SIZE, startQueries);
+    glGenQueries(RING_SIZE, endQueries);
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(RING_SIZE, startQueries);
+    glDeleteQueries(RING_SIZE, endQueries);
+}
+
+void GpuTimer::begin() {
+    // every slot still waits for the GPU: skip this measurement rather than stall
+    measuring = !pending[next];
+    if (measuring)
+        glQueryCounter(startQueries[next], GL_TIMESTAMP);
+}
+
+void GpuTimer::end() {
+    if (!measuring)
+        return;
+    glQueryCounter(endQueries[next], GL_TIMESTAMP);
+    pending[next] = true;
+    next = (next + 1) % RING_SIZE;
+    measuring = false;
+}
+
+bool GpuTimer::poll(double& milliseconds) {
+    bool collected = false;
+    // results finish in order, stop at the first one that is not ready
+    while (pending[oldest]) {
+        GLint available = 0;
+        glGetQueryObjectiv(endQueries[oldest], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+        GLuint64 start = 0, stop = 0;
+        glGetQueryObjectui64v(startQueries[oldest], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(endQueries[oldest], GL_QUERY_RESULT, &stop);
+        milliseconds = static_cast<double>(stop - start) / 1e6;
+        pending[oldest] = false;
+        oldest = (oldest + 1) % RING_SIZE;
+        collected = true;
+    }
+    return collected;
+}
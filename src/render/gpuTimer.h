@@ -0,0 +1,48 @@
+#ifndef GRAPHICS_GPUTIMER_H
+#define GRAPHICS_GPUTIMER_H
+
+#include <glad/glad.h>
+
+/**
+ * @brief Measures how long the GPU takes for a range of commands, without stalling the CPU
+ * @details begin() and end() record GPU timestamps around the commands. Results arrive a few frames later,
+ * so the timer keeps a small ring of query pairs and poll() collects those that are ready. A frame whose ring
+ * slot is still pending is skipped rather than waited for.
+ */
+class GpuTimer {
+public:
+    /// @brief Query pairs in flight (frames a result may lag behind)
+    static const int RING_SIZE = 4;
+
+    /// @brief Creates the queries (needs a current OpenGL context)
+    GpuTimer();
+
+    /// @brief Deletes the queries
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    /// @brief Marks the start of the commands to measure
+    void begin();
+
+    /// @brief Marks the end of the commands to measure
+    void end();
+
+    /// @brief Collects finished measurements
+    /// @param milliseconds Receives the newest finished measurement
+    /// @return true if a new measurement finished since the last call, false otherwise
+    bool poll(double& milliseconds);
+
+private:
+    GLuint startQueries[RING_SIZE], endQueries[RING_SIZE];
+    bool pending[RING_SIZE] = {};
+
+    /// @brief Slot the next begin() uses and the oldest slot not collected yet
+    int next = 0, oldest = 0;
+
+    /// @brief True between begin() and end() if begin() got a slot
+    bool measuring = false;
+};
+
+#endif //GRAPHICS_GPUTIMER_H
@@ -0,0 +1,154 @@
+#include "latencyMonitor.h"
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+/// Presses not shown within this many seconds are forgotten (e.g. released before a step saw them).
+static const double PRESS_TIMEOUT = 1.0;
+
+/// Most rows and widest bar of the printed histogram.
+static const int REPORT_ROWS = 25, REPORT_WIDTH = 40;
+
+LatencyMonitor::LatencyMonitor() {
+    for (Frame& frame : frames)
+        glGenQueries(1, &frame.query);
+    std::fill(pressTime, pressTime + 4, -1.0);
+}
+
+LatencyMonitor::~LatencyMonitor() {
+    for (Frame& frame : frames) {
+        glDeleteQueries(1, &frame.query);
+        if (frame.fence)
+            glDeleteSync(frame.fence);
+    }
+}
+
+void LatencyMonitor::press(uint8_t lanes, double time) {
+    for (int lane = 0; lane < 4; lane++) {
+        if (lanes & (1 << lane))
+            pressTime[lane] = time;
+    }
+}
+
+void LatencyMonitor::shows(uint8_t lanes) {
+    for (int lane = 0; lane < 4; lane++) {
+        if ((lanes & (1 << lane)) && pressTime[lane] >= 0) {
+            shownTimes[shown++] = pressTime[lane];
+            pressTime[lane] = -1.0;
+        }
+    }
+}
+
+void LatencyMonitor::endFrame() {
+    double now = glfwGetTime();
+    for (double& time : pressTime) {
+        if (time >= 0 && now - time > PRESS_TIMEOUT)
+            time = -1.0;
+    }
+    if (shown == 0)
+        return;
+    if (pending == RING_SIZE) {
+        // the GPU is that far behind; measuring would mean waiting for it
+        skipped += shown;
+        shown = 0;
+        return;
+    }
+
+    Frame& frame = frames[next];
+    glQueryCounter(frame.query, GL_TIMESTAMP);
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glGetInteger64v(GL_TIMESTAMP, &frame.gpuTime);
+    frame.cpuTime = glfwGetTime();
+    std::copy(shownTimes, shownTimes + shown, frame.pressTimes);
+    frame.presses = shown;
+    shown = 0;
+
+    next = (next + 1) % RING_SIZE;
+    pending++;
+}
+
+void LatencyMonitor::poll() {
+    // frames finish in order, stop at the first one the GPU is still working on
+    while (pending > 0) {
+        Frame& frame = frames[oldest];
+        GLenum status = glClientWaitSync(frame.fence, 0, 0);
+        if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+            break;
+        double finished = glfwGetTime();
+        GLint available = 0;
+        glGetQueryObjectiv(frame.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available) {
+            GLuint64 timestamp = 0;
+            glGetQueryObjectui64v(frame.query, GL_QUERY_RESULT, &timestamp);
+            finished = frame.cpuTime + static_cast<double>(static_cast<GLint64>(timestamp) - frame.gpuTime) / 1e9;
+        }
+        for (int i = 0; i < frame.presses; i++)
+            add((finished - frame.pressTimes[i]) * 1000.0);
+
+        glDeleteSync(frame.fence);
+        frame.fence = nullptr;
+        oldest = (oldest + 1) % RING_SIZE;
+        pending--;
+    }
+}
+
+void LatencyMonitor::add(double milliseconds) {
+    milliseconds = std::max(milliseconds, 0.0);
+    int bin = std::min(static_cast<int>(milliseconds / BIN_MS), BIN_COUNT - 1);
+    histogram[bin]++;
+    samples++;
+    maxMs = std::max(maxMs, milliseconds);
+}
+
+double LatencyMonitor::percentile(double fraction) const {
+    uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(samples - 1)), seen = 0;
+    for (int bin = 0; bin < BIN_COUNT - 1; bin++) {
+        seen += histogram[bin];
+        if (seen > rank)
+            return std::min((bin + 0.5) * BIN_MS, maxMs);
+    }
+    return maxMs;
+}
+
+void LatencyMonitor::report(const char* label) {
+    if (samples == 0) {
+        std::cout << "LATENCY: " << label << ": no presses measured" << std::endl;
+        skipped = 0;
+        return;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "LATENCY: " << label << ": " << samples << " presses, p50 " << percentile(0.50) << " ms, p95 "
+              << percentile(0.95) << " ms, p99 " << percentile(0.99) << " ms, max " << maxMs << " ms";
+    if (skipped > 0)
+        std::cout << " (" << skipped << " not measured)";
+    std::cout << std::endl;
+
+    // rows of equal width between the first and the last non-empty bin
+    int first = 0, last = BIN_COUNT - 1;
+    while (histogram[first] == 0) first++;
+    while (histogram[last] == 0) last--;
+    int binsPerRow = std::max(1, (last - first + REPORT_ROWS) / REPORT_ROWS);
+    uint32_t highest = 0;
+    for (int row = first; row <= last; row += binsPerRow) {
+        uint32_t count = 0;
+        for (int bin = row; bin < std::min(row + binsPerRow, BIN_COUNT); bin++)
+            count += histogram[bin];
+        highest = std::max(highest, count);
+    }
+    for (int row = first; row <= last; row += binsPerRow) {
+        uint32_t count = 0;
+        for (int bin = row; bin < std::min(row + binsPerRow, BIN_COUNT); bin++)
+            count += histogram[bin];
+        int bar = static_cast<int>((static_cast<uint64_t>(count) * REPORT_WIDTH + highest - 1) / highest);
+        std::cout << "LATENCY: " << std::setw(6) << row * BIN_MS << " ms " << std::string(bar, '#') << " " << count
+                  << std::endl;
+    }
+    std::cout << std::defaultfloat << std::setprecision(6);
+
+    std::fill(histogram, histogram + BIN_COUNT, 0);
+    samples = skipped = 0;
+    maxMs = 0.0;
+}
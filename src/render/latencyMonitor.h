@@ -0,0 +1,91 @@
+#ifndef GRAPHICS_LATENCYMONITOR_H
+#define GRAPHICS_LATENCYMONITOR_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Measures the time from a key press until a frame showing it has been finished by the GPU
+ * @details press() records when a lane's key went down. The first frame that lights that lane calls shows();
+ * endFrame() then puts a timestamp query and a fence behind the frame's swap. Once the fence signals (checked
+ * without waiting by poll()), the query's GPU time is converted to the CPU clock, using a pair of GPU and CPU
+ * clocks read when the frame was submitted, and the difference to the press goes into a histogram.
+ * Without a timestamp result, the time poll() saw the fence signaled is used instead.
+ *
+ * The measurement ends where OpenGL can see: the display's scanout after the swap is not included, so photons
+ * appear up to a refresh interval later. All storage is fixed, measuring does not allocate.
+ */
+class LatencyMonitor {
+public:
+    /// @brief Frames that may be waiting for the GPU at once; presses shown by further frames are not measured
+    static constexpr int RING_SIZE = 8;
+
+    /// @brief Width of a histogram bin and number of bins, the last one collects everything longer
+    static constexpr double BIN_MS = 0.5;
+    static constexpr int BIN_COUNT = 400;
+
+    /// @brief Creates the timestamp queries (needs a current OpenGL context)
+    LatencyMonitor();
+
+    /// @brief Deletes the queries and pending fences
+    ~LatencyMonitor();
+
+    LatencyMonitor(const LatencyMonitor&) = delete;
+    LatencyMonitor& operator=(const LatencyMonitor&) = delete;
+
+    /// @brief Records key presses
+    /// @param lanes Bit per lane (1 << Lane) whose key just went down
+    /// @param time glfwGetTime() when the press was read
+    void press(uint8_t lanes, double time);
+
+    /// @brief Marks the lanes the frame being drawn shows as pressed
+    void shows(uint8_t lanes);
+
+    /// @brief Ends the frame, call right after its swap
+    void endFrame();
+
+    /// @brief Collects the frames the GPU has finished, without waiting
+    void poll();
+
+    /// @brief Prints the number of presses, p50/p95/p99 and a histogram, then starts over
+    /// @param label What was measured, e.g. "Session 2"
+    void report(const char* label);
+
+    /// @brief Returns the number of presses measured since the last report
+    uint64_t getSampleCount() const { return samples; }
+
+private:
+    /// @brief A submitted frame that showed presses
+    struct Frame {
+        GLsync fence = nullptr;
+        GLuint query = 0;
+        /// @brief CPU and GPU clocks read together at submission, to convert the query result
+        double cpuTime = 0.0;
+        GLint64 gpuTime = 0;
+        double pressTimes[4] = {};
+        int presses = 0;
+    };
+
+    Frame frames[RING_SIZE];
+    int next = 0, oldest = 0, pending = 0;
+
+    /// @brief Per lane, time of a press not shown yet (negative if none)
+    double pressTime[4];
+
+    /// @brief Presses shown by the frame being drawn
+    double shownTimes[4] = {};
+    int shown = 0;
+
+    uint32_t histogram[BIN_COUNT] = {};
+    uint64_t samples = 0, skipped = 0;
+    double maxMs = 0.0;
+
+    /// @brief Adds a measured latency
+    void add(double milliseconds);
+
+    /// @brief Returns the latency below which the given fraction of the samples lie
+    double percentile(double fraction) const;
+};
+
+#endif //GRAPHICS_LATENCYMONITOR_H
@@ -0,0 +1,99 @@
+#include "particlePool.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define PARTICLES_SSE2 1
+#include <emmintrin.h>
+#endif
+
+ParticlePool::ParticlePool(size_t capacity)
+    : x(capacity), y(capacity), vx(capacity), vy(capacity), life(capacity), inverseLifetime(capacity),
+      color(capacity) {}
+
+bool ParticlePool::emit(float px, float py, float pvx, float pvy, float lifetime, uint32_t rgba) {
+    if (count == capacity() || lifetime <= 0) {
+        dropped += count == capacity();
+        return false;
+    }
+    x[count] = px;
+    y[count] = py;
+    vx[count] = pvx;
+    vy[count] = pvy;
+    life[count] = lifetime;
+    inverseLifetime[count] = 1.0f / lifetime;
+    color[count] = rgba;
+    count++;
+    return true;
+}
+
+// Integrates particles [begin, end), also handles the tail the vector version leaves over.
+static void integrateScalar(float* x, float* y, float* vx, float* vy, float* life, size_t begin, size_t end,
+                            float dt, float dvy, float damping) {
+    for (size_t i = begin; i < end; i++) {
+        vx[i] = vx[i] * damping;
+        vy[i] = vy[i] * damping + dvy;
+        x[i] += vx[i] * dt;
+        y[i] += vy[i] * dt;
+        life[i] -= dt;
+    }
+}
+
+void ParticlePool::update(float dt, float gravity, float drag) {
+    integrate(0, count, dt, gravity, drag);
+    removeDead();
+}
+
+void ParticlePool::integrate(size_t begin, size_t end, float dt, float gravity, float drag) {
+    float damping = std::max(0.0f, 1.0f - drag * dt);
+    float dvy = gravity * dt;
+    float *px = x.data(), *py = y.data(), *pvx = vx.data(), *pvy = vy.data(), *plife = life.data();
+
+    size_t i = begin;
+#ifdef PARTICLES_SSE2
+    const __m128 dt4 = _mm_set1_ps(dt), dvy4 = _mm_set1_ps(dvy), damping4 = _mm_set1_ps(damping);
+    for (; i + 4 <= end; i += 4) {
+        __m128 newVx = _mm_mul_ps(_mm_loadu_ps(pvx + i), damping4);
+        __m128 newVy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pvy + i), damping4), dvy4);
+        _mm_storeu_ps(pvx + i, newVx);
+        _mm_storeu_ps(pvy + i, newVy);
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(newVx, dt4)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(newVy, dt4)));
+        _mm_storeu_ps(plife + i, _mm_sub_ps(_mm_loadu_ps(plife + i), dt4));
+    }
+#endif
+    integrateScalar(px, py, pvx, pvy, plife, i, end, dt, dvy, damping);
+}
+
+void ParticlePool::removeDead() {
+    // the particle moved into a hole is checked before moving on
+    for (size_t j = 0; j < count;) {
+        if (life[j] > 0)
+            j++;
+        else
+            move(--count, j);
+    }
+}
+
+void ParticlePool::move(size_t from, size_t to) {
+    x[to] = x[from];
+    y[to] = y[from];
+    vx[to] = vx[from];
+    vy[to] = vy[from];
+    life[to] = life[from];
+    inverseLifetime[to] = inverseLifetime[from];
+    color[to] = color[from];
+}
+
+void ParticlePool::writeInstances(ParticleInstance* out, float size, size_t begin, size_t end) const {
+    for (size_t i = begin; i < end; i++) {
+        float fraction = std::min(life[i] * inverseLifetime[i], 1.0f);
+        uint32_t alpha = static_cast<uint32_t>((color[i] >> 24) * fraction);
+        out[i] = {x[i], y[i], size * (0.5f + 0.5f * fraction), (color[i] & 0x00FFFFFFu) | (alpha << 24)};
+    }
+}
+
+uint32_t packColor(float red, float green, float blue, float alpha) {
+    auto channel = [](float value) { return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f); };
+    return channel(red) | channel(green) << 8 | channel(blue) << 16 | channel(alpha) << 24;
+}
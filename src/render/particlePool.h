@@ -0,0 +1,90 @@
+#ifndef GRAPHICS_PARTICLEPOOL_H
+#define GRAPHICS_PARTICLEPOOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+/// @brief Per-instance data of one particle quad, as uploaded to the GPU.
+struct ParticleInstance {
+    /// @brief Center and edge length of the quad
+    float x, y, size;
+
+    /// @brief RGBA8 color, alpha already faded by the particle's remaining life
+    uint32_t color;
+};
+
+/**
+ * @brief Fixed-capacity pool of particles, stored as a structure of arrays
+ * @details All memory is allocated by the constructor; emitting never allocates and fails once the pool is full.
+ * update() integrates every particle with SSE2 (scalar elsewhere and for the tail) and removes the dead ones by
+ * moving the last particle into their place, so live particles always occupy indices 0 to size() - 1. Integration
+ * and writing instances also work on ranges, so they can be split over threads.
+ * The pool knows nothing about OpenGL, it only writes instances for the renderer to upload.
+ */
+class ParticlePool {
+public:
+    /// @brief Construct a new Particle Pool object
+    /// @param capacity Most particles alive at once
+    explicit ParticlePool(size_t capacity);
+
+    /// @brief Adds a particle
+    /// @param x The x position
+    /// @param y The y position
+    /// @param vx The x velocity in pixels per second
+    /// @param vy The y velocity in pixels per second
+    /// @param lifetime Seconds until the particle disappears
+    /// @param color RGBA8 color at full life
+    /// @return true if added, false if the pool is full
+    bool emit(float x, float y, float vx, float vy, float lifetime, uint32_t color);
+
+    /// @brief Advances every particle and removes those whose life ran out
+    /// @param dt Seconds to advance
+    /// @param gravity Acceleration along y in pixels per second squared (negative is down)
+    /// @param drag Fraction of the velocity lost per second
+    void update(float dt, float gravity, float drag);
+
+    /// @brief Advances the particles [begin, end) without removing any, ranges may run on different threads
+    void integrate(size_t begin, size_t end, float dt, float gravity, float drag);
+
+    /// @brief Removes the particles whose life ran out
+    void removeDead();
+
+    /// @brief Writes the instances of the particles [begin, end), fading color and size with the remaining life
+    /// @param out Receives the instance of particle i at out[i]
+    /// @param size Edge length of a particle at full life
+    void writeInstances(ParticleInstance* out, float size, size_t begin, size_t end) const;
+
+    /// @brief Removes all particles
+    void clear() { count = 0; }
+
+    /// @brief Returns the number of live particles
+    size_t size() const { return count; }
+
+    /// @brief Returns the most particles alive at once
+    size_t capacity() const { return x.size(); }
+
+    /// @brief Returns the number of particles emit() rejected because the pool was full
+    uint64_t getDropped() const { return dropped; }
+
+private:
+    size_t count = 0;
+    uint64_t dropped = 0;
+
+    vector<float> x, y, vx, vy;
+
+    /// @brief Seconds left, and 1 / lifetime to turn that into a fraction
+    vector<float> life, inverseLifetime;
+
+    vector<uint32_t> color;
+
+    /// @brief Moves the particle at from into index to
+    void move(size_t from, size_t to);
+};
+
+/// @brief Packs a color with components in [0, 1] into RGBA8 (red in the lowest byte)
+uint32_t packColor(float red, float green, float blue, float alpha);
+
+#endif //GRAPHICS_PARTICLEPOOL_H
@@ -0,0 +1,139 @@
+#include "particleSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/// Emitters by ParticleType. Sparks fly up in a fan; glows drift a little in any direction.
+static const ParticleEmitter EMITTERS[PARTICLE_TYPE_COUNT] = {
+    // capacity, perBurst, speed, angle, lifetime, size, gravity, drag
+    {65536, 48, 150.0f, 450.0f, 0.35f, 2.79f, 0.35f, 0.7f, 4.0f, -900.0f, 1.5f},
+    {8192, 6, 20.0f, 80.0f, 0.0f, 6.2832f, 0.5f, 0.9f, 28.0f, 0.0f, 2.0f}
+};
+
+/// Particles per job when the update is spread over threads; smaller pools are not worth waking them for.
+static const size_t PARTICLES_PER_JOB = 8192;
+
+/// Corners of the unit quad around a particle's center, as a triangle strip.
+static const float QUAD[] = {-0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f};
+
+ParticleSystem::ParticleSystem(Shader& shader, StreamBuffer& stream, uint64_t seed)
+    : shader(shader), random(seed),
+      pools{ParticlePool(EMITTERS[PARTICLE_SPARK].capacity), ParticlePool(EMITTERS[PARTICLE_GLOW].capacity)},
+      stream(stream) {
+    glGenBuffers(1, &quadVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(QUAD), QUAD, GL_STATIC_DRAW);
+
+    glGenVertexArrays(PARTICLE_TYPE_COUNT, VAO);
+    for (int type = 0; type < PARTICLE_TYPE_COUNT; type++) {
+        instances[type].resize(EMITTERS[type].capacity);
+
+        glBindVertexArray(VAO[type]);
+        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        // <vec3 center and size, normalized RGBA8 color> per instance, pointed at the stream buffer by draw()
+        glEnableVertexAttribArray(1);
+        glEnableVertexAttribArray(2);
+        glVertexAttribDivisor(1, 1);
+        glVertexAttribDivisor(2, 1);
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+ParticleSystem::~ParticleSystem() {
+    glDeleteVertexArrays(PARTICLE_TYPE_COUNT, VAO);
+    glDeleteBuffers(1, &quadVBO);
+}
+
+void ParticleSystem::burst(glm::vec2 position, const color& tint) {
+    uint32_t rgba = packColor(tint.red, tint.green, tint.blue, tint.alpha);
+    for (int type = 0; type < PARTICLE_TYPE_COUNT; type++) {
+        const ParticleEmitter& emitter = EMITTERS[type];
+        for (unsigned i = 0; i < emitter.perBurst; i++) {
+            float speed = emitter.minSpeed + (emitter.maxSpeed - emitter.minSpeed) * random.nextFloat();
+            float angle = emitter.minAngle + (emitter.maxAngle - emitter.minAngle) * random.nextFloat();
+            float lifetime = emitter.minLifetime + (emitter.maxLifetime - emitter.minLifetime) * random.nextFloat();
+            pools[type].emit(position.x, position.y, speed * std::cos(angle), speed * std::sin(angle), lifetime, rgba);
+        }
+    }
+}
+
+void ParticleSystem::update(float dt, JobSystem* jobs) {
+    for (int type = 0; type < PARTICLE_TYPE_COUNT; type++) {
+        ParticlePool& pool = pools[type];
+        const ParticleEmitter& emitter = EMITTERS[type];
+        ParticleInstance* out = instances[type].data();
+        if (!jobs || pool.size() <= PARTICLES_PER_JOB) {
+            pool.update(dt, emitter.gravity, emitter.drag);
+            pool.writeInstances(out, emitter.size, 0, pool.size());
+            continue;
+        }
+        // only removing the dead has to see the whole pool at once
+        jobs->parallelFor(pool.size(), PARTICLES_PER_JOB, [&](size_t begin, size_t end) {
+            pool.integrate(begin, end, dt, emitter.gravity, emitter.drag);
+        });
+        pool.removeDead();
+        jobs->parallelFor(pool.size(), PARTICLES_PER_JOB, [&](size_t begin, size_t end) {
+            pool.writeInstances(out, emitter.size, begin, end);
+        });
+    }
+}
+
+void ParticleSystem::draw(const glm::mat4& projection) {
+    if (getLiveCount() == 0)
+        return;
+    shader.use();
+    shader.setMatrix4("projection", projection);
+
+    // additive, so overlapping particles brighten instead of hiding each other
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+    for (int type = 0; type < PARTICLE_TYPE_COUNT; type++) {
+        size_t count = pools[type].size();
+        if (count == 0)
+            continue;
+        GLintptr offset = stream.upload(instances[type].data(), count * sizeof(ParticleInstance),
+                                        sizeof(ParticleInstance));
+        if (offset < 0)
+            continue;
+
+        glBindVertexArray(VAO[type]);
+        glBindBuffer(GL_ARRAY_BUFFER, stream.getBuffer());
+        glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offset);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ParticleInstance),
+                              (void*)(offset + offsetof(ParticleInstance, color)));
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(count));
+    }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+void ParticleSystem::clear() {
+    for (ParticlePool& pool : pools)
+        pool.clear();
+}
+
+size_t ParticleSystem::getLiveCount() const {
+    size_t count = 0;
+    for (const ParticlePool& pool : pools)
+        count += pool.size();
+    return count;
+}
+
+uint64_t ParticleSystem::getDropped() const {
+    uint64_t dropped = 0;
+    for (const ParticlePool& pool : pools)
+        dropped += pool.getDropped();
+    return dropped;
+}
+
+size_t ParticleSystem::getMaxUploadSize() {
+    size_t largest = 0;
+    for (const ParticleEmitter& emitter : EMITTERS)
+        largest = std::max(largest, emitter.capacity * sizeof(ParticleInstance));
+    return largest;
+}
@@ -0,0 +1,105 @@
+#ifndef GRAPHICS_PARTICLESYSTEM_H
+#define GRAPHICS_PARTICLESYSTEM_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "particlePool.h"
+#include "streamBuffer.h"
+#include "../jobs/jobSystem.h"
+#include "../shader/shader.h"
+#include "../util/color.h"
+#include "../util/random.h"
+
+/// @brief Kinds of particles, each kept in its own pool and drawn with one instanced draw call
+enum ParticleType {
+    /// Small, fast sparks thrown up and pulled down again
+    PARTICLE_SPARK,
+    /// Few large, slow blobs that make the hit glow
+    PARTICLE_GLOW,
+    PARTICLE_TYPE_COUNT
+};
+
+/// @brief How the particles of one type are emitted and move
+struct ParticleEmitter {
+    /// @brief Most particles of this type alive at once
+    size_t capacity;
+
+    /// @brief Particles emitted per burst
+    unsigned perBurst;
+
+    /// @brief Range of the initial speed (pixels per second) and direction (radians, 0 is right)
+    float minSpeed, maxSpeed, minAngle, maxAngle;
+
+    /// @brief Range of the lifetime in seconds
+    float minLifetime, maxLifetime;
+
+    /// @brief Edge length at full life in pixels
+    float size;
+
+    /// @brief Acceleration along y (negative is down) and fraction of the velocity lost per second
+    float gravity, drag;
+};
+
+/**
+ * @brief Hit feedback particles
+ * @details Every type has a preallocated ParticlePool and instance array of the same capacity, so bursts never
+ * allocate and drawing costs one instanced draw call per type however many particles are alive. update() does all
+ * CPU work (integration and filling the instance arrays); draw() only streams the instances and draws.
+ * Particles are purely visual and use their own random generator, so they never affect the session's state.
+ */
+class ParticleSystem {
+public:
+    /// @brief Creates the pools and GPU buffers (needs a current OpenGL context)
+    /// @param shader The particle shader
+    /// @param stream The buffer instances are streamed through, must outlive the system
+    /// @param seed Seed of the random spread of bursts
+    ParticleSystem(Shader& shader, StreamBuffer& stream, uint64_t seed = 1);
+
+    /// @brief Deletes the GPU buffers
+    ~ParticleSystem();
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    /// @brief Emits a burst of every type
+    /// @param position Where the burst starts
+    /// @param tint Color of the particles
+    void burst(glm::vec2 position, const color& tint);
+
+    /// @brief Advances all particles and prepares their instances for draw()
+    /// @param dt Seconds since the last update
+    /// @param jobs Spreads large pools over its threads, may be null
+    void update(float dt, JobSystem* jobs = nullptr);
+
+    /// @brief Draws all particles additively, one instanced draw call per type
+    void draw(const glm::mat4& projection);
+
+    /// @brief Removes all particles
+    void clear();
+
+    /// @brief Returns the number of live particles of all types
+    size_t getLiveCount() const;
+
+    /// @brief Returns the number of particles dropped because their pool was full
+    uint64_t getDropped() const;
+
+    /// @brief Returns the largest instance upload, the stream buffer's sections have to hold it
+    static size_t getMaxUploadSize();
+
+private:
+    Shader shader;
+    Random random;
+
+    ParticlePool pools[PARTICLE_TYPE_COUNT];
+
+    /// @brief Instances written by update(), uploaded by draw()
+    vector<ParticleInstance> instances[PARTICLE_TYPE_COUNT];
+
+    StreamBuffer& stream;
+
+    /// @brief One VAO per type, sharing the quad's vertex buffer; instances come from the stream buffer
+    GLuint VAO[PARTICLE_TYPE_COUNT] = {}, quadVBO = 0;
+};
+
+#endif //GRAPHICS_PARTICLESYSTEM_H
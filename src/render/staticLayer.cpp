@@ -0,0 +1,88 @@
+#include "staticLayer.h"
+
+#include <iostream>
+
+StaticLayer::StaticLayer(Shader& shapeShader, Shader& layerShader, int width, int height)
+    : shapeShader(shapeShader), layerShader(layerShader), width(width), height(height) {
+    glGenTextures(1, &colorTexture);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+        std::cout << "ERROR::LAYER: Could not create the static layer texture, drawing its shapes every frame" << std::endl;
+
+    glGenVertexArrays(1, &VAO);
+}
+
+StaticLayer::~StaticLayer() {
+    glDeleteVertexArrays(1, &VAO);
+    glDeleteFramebuffers(1, &framebuffer);
+    glDeleteTextures(1, &colorTexture);
+}
+
+void StaticLayer::add(Shape& shape) {
+    shapes.push_back(&shape);
+    stale = true;
+}
+
+void StaticLayer::draw() {
+    if (!complete) {
+        for (Shape* shape : shapes) {
+            shape->setUniforms();
+            shape->draw();
+        }
+        return;
+    }
+
+    bool dirty = stale;
+    for (const Shape* shape : shapes)
+        dirty |= shape->isDirty();
+    if (dirty)
+        rebuild();
+
+    layerShader.use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, colorTexture);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    glBindVertexArray(VAO);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindVertexArray(0);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    shapeShader.use();
+}
+
+void StaticLayer::rebuild() {
+    // the layer may be drawn while another target (the dynamic resolution playfield) is bound
+    GLint previousFramebuffer = 0, viewport[4];
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &previousFramebuffer);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, width, height);
+    const GLfloat transparent[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    glClearBufferfv(GL_COLOR, 0, transparent);
+
+    // color is stored premultiplied, alpha accumulates coverage, so compositing matches drawing directly
+    glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    for (Shape* shape : shapes) {
+        shape->setUniforms();
+        shape->draw();
+        shape->clearDirty();
+    }
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, previousFramebuffer);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    stale = false;
+    rebuilds++;
+}
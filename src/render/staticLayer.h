@@ -0,0 +1,72 @@
+#ifndef GRAPHICS_STATICLAYER_H
+#define GRAPHICS_STATICLAYER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+
+#include "../shader/shader.h"
+#include "../shapes/shape.h"
+
+using std::vector;
+
+/**
+ * @brief Shapes that rarely change, drawn once into a texture and then composited with a single quad per frame
+ * @details The layer is redrawn only when one of its shapes reports a change through Shape::isDirty(), so the
+ * setUniforms()/draw() pair of every shape is paid once per change instead of once per frame. Shapes are drawn into
+ * the texture with premultiplied alpha and composited with (ONE, ONE_MINUS_SRC_ALPHA), which blends exactly like
+ * drawing them straight into the frame. The texture has the size of the window; the quad covers the viewport, so
+ * the layer also works inside a scaled DynamicResolution playfield.
+ * If the texture cannot be rendered to, draw() draws the shapes directly every frame.
+ */
+class StaticLayer {
+public:
+    /// @brief Creates the texture (needs a current OpenGL context)
+    /// @param shapeShader The shader the shapes draw with (with its projection set)
+    /// @param layerShader The shader compositing the texture
+    /// @param width Width of the window in pixels
+    /// @param height Height of the window in pixels
+    StaticLayer(Shader& shapeShader, Shader& layerShader, int width, int height);
+
+    /// @brief Deletes the texture
+    ~StaticLayer();
+
+    StaticLayer(const StaticLayer&) = delete;
+    StaticLayer& operator=(const StaticLayer&) = delete;
+
+    /// @brief Adds a shape on top of those added before (not owned, must outlive the layer)
+    /// @details A shape should belong to one layer only, since redrawing a layer clears the shape's dirty flag.
+    void add(Shape& shape);
+
+    /// @brief Draws the layer, redrawing its texture first if a shape changed
+    /// @details Expects the shape shader in use and leaves it in use.
+    void draw();
+
+    /// @brief Returns true if the layer is cached in a texture
+    bool isComplete() const { return complete; }
+
+    /// @brief Returns how often the texture was redrawn
+    uint64_t getRebuilds() const { return rebuilds; }
+
+private:
+    Shader shapeShader, layerShader;
+    int width, height;
+    vector<Shape*> shapes;
+
+    GLuint framebuffer = 0, colorTexture = 0;
+
+    /// @brief Empty VAO the quad is drawn with, its corners come from gl_VertexID
+    GLuint VAO = 0;
+
+    bool complete = false;
+
+    /// @brief Set while the texture does not hold the shapes (before the first draw, after add())
+    bool stale = true;
+
+    uint64_t rebuilds = 0;
+
+    /// @brief Draws every shape into the texture
+    void rebuild();
+};
+
+#endif //GRAPHICS_STATICLAYER_H
@@ -0,0 +1,137 @@
+#include "streamBuffer.h"
+
+#include <GLFW/glfw3.h>
+#include <cstring>
+#include <iostream>
+
+// ARB_buffer_storage is not part of the 3.3 core context, so its entry point and flags are looked up here
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+typedef void (APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+/// Sections start at multiples of this, so every alignment up to it holds within the whole buffer.
+static const size_t SECTION_ALIGNMENT = 256;
+
+/// Longest single wait for a fence in nanoseconds.
+static const GLuint64 WAIT_TIMEOUT = 100000000;
+
+/// Returns glBufferStorage if the context supports it, null otherwise.
+static BufferStorageProc getBufferStorage() {
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+    bool supported = major > 4 || (major == 4 && minor >= 4);
+
+    GLint extensions = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensions);
+    for (GLint i = 0; i < extensions && !supported; i++) {
+        const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+        supported = name && !strcmp(name, "GL_ARB_buffer_storage");
+    }
+    return supported ? reinterpret_cast<BufferStorageProc>(glfwGetProcAddress("glBufferStorage")) : nullptr;
+}
+
+StreamBuffer::StreamBuffer(size_t sectionSize)
+    : sectionSize((sectionSize + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT) {
+    GLsizeiptr size = static_cast<GLsizeiptr>(this->sectionSize * SECTION_COUNT);
+    const GLbitfield persistent = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // GL_COPY_WRITE_BUFFER leaves the vertex buffer binding alone
+    glGenBuffers(1, &buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+    if (BufferStorageProc bufferStorage = getBufferStorage()) {
+        bufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, persistent);
+        mapped = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, persistent));
+        if (!mapped) {
+            // storage is immutable, start over with a plain buffer
+            glDeleteBuffers(1, &buffer);
+            glGenBuffers(1, &buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        }
+    }
+    if (!mapped)
+        glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+StreamBuffer::~StreamBuffer() {
+    for (GLsync fence : fences) {
+        if (fence)
+            glDeleteSync(fence);
+    }
+    if (mapped) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+    glDeleteBuffers(1, &buffer);
+}
+
+GLintptr StreamBuffer::upload(const void* data, size_t bytes, size_t alignment) {
+    if (bytes > sectionSize) {
+        std::cout << "ERROR::STREAM: Upload of " << bytes << " bytes is larger than a section (" << sectionSize
+                  << " bytes)" << std::endl;
+        return -1;
+    }
+    size_t offset = (head + alignment - 1) / alignment * alignment;
+    if (offset + bytes > sectionSize) {
+        nextSection();
+        offset = 0;
+    }
+    if (waitPending)
+        waitForSection();
+
+    size_t position = section * sectionSize + offset;
+    if (mapped) {
+        std::memcpy(mapped + position, data, bytes);
+    } else {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        void* range = glMapBufferRange(GL_COPY_WRITE_BUFFER, static_cast<GLintptr>(position),
+                                       static_cast<GLsizeiptr>(bytes),
+                                       GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        if (range) {
+            std::memcpy(range, data, bytes);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        if (!range)
+            return -1;
+    }
+    head = offset + bytes;
+    return static_cast<GLintptr>(position);
+}
+
+void StreamBuffer::endFrame() {
+    // the next frame starts in a fresh section, so a whole section is fenced per frame
+    if (head > 0)
+        nextSection();
+}
+
+void StreamBuffer::nextSection() {
+    if (fences[section])
+        glDeleteSync(fences[section]);
+    fences[section] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    section = (section + 1) % SECTION_COUNT;
+    head = 0;
+    waitPending = true;
+}
+
+void StreamBuffer::waitForSection() {
+    waitPending = false;
+    GLsync fence = fences[section];
+    if (!fence)
+        return;
+    GLenum status = glClientWaitSync(fence, 0, 0);
+    if (status == GL_TIMEOUT_EXPIRED) {
+        stalls++;
+        do
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, WAIT_TIMEOUT);
+        while (status == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fences[section] = nullptr;
+}
@@ -0,0 +1,78 @@
+#ifndef GRAPHICS_STREAMBUFFER_H
+#define GRAPHICS_STREAMBUFFER_H
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Ring buffer that per-frame vertex data is streamed through without waiting for the GPU
+ * @details The buffer is split into SECTION_COUNT sections used round-robin. Uploads are sub-allocated from the
+ * current section; at endFrame(), or when the section is full, it is fenced and the next section is taken, after
+ * its fence from SECTION_COUNT sections ago has signaled. The GPU is therefore never reading the range written.
+ *
+ * With OpenGL 4.4 or ARB_buffer_storage the buffer is mapped once, persistently and coherently, and uploads are
+ * plain copies. Otherwise each upload maps its range with glMapBufferRange(UNSYNCHRONIZED): the fences already
+ * guarantee what the driver would otherwise have to wait for.
+ */
+class StreamBuffer {
+public:
+    /// @brief Sections the ring is split into, about the frames one section is reused after
+    static constexpr int SECTION_COUNT = 3;
+
+    /// @brief Creates and maps the buffer (needs a current OpenGL context)
+    /// @param sectionSize Bytes per section, the largest single upload
+    explicit StreamBuffer(size_t sectionSize);
+
+    /// @brief Unmaps and deletes the buffer
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    /// @brief Copies data into the ring
+    /// @param data The bytes to upload
+    /// @param bytes Number of bytes, at most the section size
+    /// @param alignment Alignment of the returned offset, e.g. the vertex stride
+    /// @return The offset of the data in getBuffer(), -1 if it does not fit in a section
+    GLintptr upload(const void* data, size_t bytes, size_t alignment);
+
+    /// @brief Fences the data uploaded this frame, call right after the swap
+    void endFrame();
+
+    /// @brief Returns the buffer to source vertex attributes from
+    GLuint getBuffer() const { return buffer; }
+
+    /// @brief Returns true if the buffer is persistently mapped
+    bool isPersistent() const { return mapped != nullptr; }
+
+    /// @brief Returns the number of sections that were still in use by the GPU when taken
+    uint64_t getStalls() const { return stalls; }
+
+private:
+    GLuint buffer = 0;
+    size_t sectionSize;
+
+    /// @brief The persistent mapping, null when every upload maps its own range
+    unsigned char* mapped = nullptr;
+
+    /// @brief Fence of every section the GPU may still read
+    GLsync fences[SECTION_COUNT] = {};
+
+    /// @brief The section uploads go to, and the next free byte in it
+    int section = 0;
+    size_t head = 0;
+
+    /// @brief True until the current section's fence was waited for
+    bool waitPending = false;
+
+    uint64_t stalls = 0;
+
+    /// @brief Fences the current section and moves on to the next one
+    void nextSection();
+
+    /// @brief Waits until the GPU is done with the current section
+    void waitForSection();
+};
+
+#endif //GRAPHICS_STREAMBUFFER_H
@@ -0,0 +1,142 @@
+#include "replay.h"
+#include "../util/binaryIO.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using std::cout, std::endl;
+
+static const char MAGIC[4] = {'A', 'D', 'R', 'P'};
+static const uint16_t VERSION = 4;
+
+void Replay::recordButtons(uint32_t tick, uint8_t buttons) {
+    if (buttons == lastButtons) return;
+    events.push_back({tick, buttons});
+    lastButtons = buttons;
+}
+
+void Replay::recordHash(uint64_t hash) {
+    hashes.push_back(hash);
+}
+
+void Replay::truncate(uint32_t tickCount) {
+    while (!events.empty() && events.back().tick >= tickCount)
+        events.pop_back();
+    if (hashes.size() > tickCount)
+        hashes.resize(tickCount);
+    lastButtons = events.empty() ? 0 : events.back().buttons;
+}
+
+bool Replay::save(const string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        cout << "ERROR::REPLAY: Could not open " << path << " for writing" << endl;
+        return false;
+    }
+
+    out.write(MAGIC, sizeof(MAGIC));
+    writeLE<uint16_t>(out, VERSION);
+    writeLE<uint16_t>(out, 0);
+    writeLE<uint64_t>(out, config.seed);
+    writeLE<float>(out, config.startSpeed);
+    writeLE<float>(out, config.simRate);
+    writeLE<uint32_t>(out, static_cast<uint32_t>(hashes.size()));
+    writeLE<uint32_t>(out, static_cast<uint32_t>(events.size()));
+
+    uint32_t previousTick = 0;
+    for (const Event& event : events) {
+        writeVarint(out, event.tick - previousTick);
+        out.put(static_cast<char>(event.buttons));
+        previousTick = event.tick;
+    }
+    for (uint64_t hash : hashes)
+        writeLE<uint64_t>(out, hash);
+
+    if (!out) {
+        cout << "ERROR::REPLAY: Failed writing " << path << endl;
+        return false;
+    }
+    return true;
+}
+
+bool Replay::load(const string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        cout << "ERROR::REPLAY: Could not open " << path << endl;
+        return false;
+    }
+
+    char magic[4];
+    uint16_t version, reserved;
+    uint32_t tickCount, eventCount;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) {
+        cout << "ERROR::REPLAY: " << path << " is not a replay file" << endl;
+        return false;
+    }
+    if (!readLE(in, version)) {
+        cout << "ERROR::REPLAY: Truncated header in " << path << endl;
+        return false;
+    }
+    if (version != VERSION) {
+        cout << "ERROR::REPLAY: Unsupported replay version " << version << endl;
+        return false;
+    }
+    if (!readLE(in, reserved) || !readLE(in, config.seed) || !readLE(in, config.startSpeed) || !readLE(in, config.simRate) ||
+        !readLE(in, tickCount) || !readLE(in, eventCount)) {
+        cout << "ERROR::REPLAY: Truncated header in " << path << endl;
+        return false;
+    }
+    if (!EngineConfig::isValidSimRate(config.simRate)) {
+        cout << "ERROR::REPLAY: Invalid simulation rate " << config.simRate << " in " << path << endl;
+        return false;
+    }
+
+    // an event takes at least 2 bytes and a tick 8, so counts the rest of the file cannot hold are corrupt;
+    // checking before reserving keeps a bad header from asking for gigabytes
+    std::streamoff dataStart = in.tellg();
+    in.seekg(0, std::ios::end);
+    uint64_t remaining = static_cast<uint64_t>(in.tellg() - dataStart);
+    in.seekg(dataStart);
+    if (uint64_t(eventCount) * 2 + uint64_t(tickCount) * 8 > remaining) {
+        cout << "ERROR::REPLAY: " << path << " is too short for " << eventCount << " input events and "
+             << tickCount << " ticks" << endl;
+        return false;
+    }
+
+    events.clear();
+    events.reserve(eventCount);
+    uint32_t tick = 0;
+    for (uint32_t i = 0; i < eventCount; i++) {
+        uint64_t delta;
+        int buttons;
+        if (!readVarint(in, delta) || (buttons = in.get()) == EOF) {
+            cout << "ERROR::REPLAY: Truncated input events in " << path << endl;
+            return false;
+        }
+        tick += static_cast<uint32_t>(delta);
+        events.push_back({tick, static_cast<uint8_t>(buttons)});
+    }
+
+    hashes.resize(tickCount);
+    for (uint32_t i = 0; i < tickCount; i++) {
+        if (!readLE(in, hashes[i])) {
+            cout << "ERROR::REPLAY: Truncated tick data in " << path << endl;
+            return false;
+        }
+    }
+
+    nextEvent = 0;
+    lastButtons = 0;
+    return true;
+}
+
+uint8_t Replay::getButtons(uint32_t tick) {
+    while (nextEvent < events.size() && events[nextEvent].tick <= tick)
+        lastButtons = events[nextEvent++].buttons;
+    return lastButtons;
+}
+
+uint64_t Replay::getHash(uint32_t tick) const     { return hashes[tick]; }
+uint32_t Replay::getTickCount() const             { return static_cast<uint32_t>(hashes.size()); }
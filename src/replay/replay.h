@@ -0,0 +1,83 @@
+#ifndef GRAPHICS_REPLAY_H
+#define GRAPHICS_REPLAY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../engineConfig.h"
+
+using std::string, std::vector;
+
+/**
+ * @brief A recorded session
+ * @details Holds the engine configuration, the input event stream and, for every simulation step (tick), a hash of
+ * the game state after the step. Steps have a fixed length, so playing a replay back only has to feed the same
+ * inputs to the same ticks; the hashes tell us the first tick at which the simulation no longer matches.
+ *
+ * File layout (little endian):
+ *   header: "ADRP", u16 version, u16 reserved, u64 seed, f32 startSpeed, f32 simRate, u32 tickCount, u32 eventCount
+ *   events: eventCount x { varint ticks since previous event, u8 buttons }
+ *   hashes: tickCount x u64 state hash
+ */
+class Replay {
+public:
+    /// @brief The configuration the session was started with
+    EngineConfig config;
+
+    // --------------------------------------------------------
+    // Recording
+    // --------------------------------------------------------
+
+    /// @brief Records the buttons held during a tick
+    /// @details Only changes are stored, so a held key costs nothing after its press event.
+    /// @param tick The tick the buttons were applied in
+    /// @param buttons Bitmask of held buttons
+    void recordButtons(uint32_t tick, uint8_t buttons);
+
+    /// @brief Records the state hash the next tick ended with
+    void recordHash(uint64_t hash);
+
+    /// @brief Drops everything recorded for ticks from tickCount on, to record them again
+    void truncate(uint32_t tickCount);
+
+    /// @brief Writes the replay to a file
+    /// @return true if successful, false otherwise
+    bool save(const string& path) const;
+
+    // --------------------------------------------------------
+    // Playback
+    // --------------------------------------------------------
+
+    /// @brief Reads a replay from a file
+    /// @return true if successful, false otherwise
+    bool load(const string& path);
+
+    /// @brief Returns the buttons held during a tick
+    /// @note Ticks must be queried in increasing order.
+    uint8_t getButtons(uint32_t tick);
+
+    /// @brief Returns the state hash the tick was recorded with
+    uint64_t getHash(uint32_t tick) const;
+
+    /// @brief Returns the number of recorded ticks
+    uint32_t getTickCount() const;
+
+private:
+    /// @brief A change of the held buttons
+    struct Event {
+        uint32_t tick;
+        uint8_t buttons;
+    };
+
+    vector<Event> events;
+    vector<uint64_t> hashes;
+
+    /// @brief Buttons as of the last recorded event
+    uint8_t lastButtons = 0;
+
+    /// @brief Index of the next event to apply during playback
+    size_t nextEvent = 0;
+};
+
+#endif //GRAPHICS_REPLAY_H
@@ -1,14 +1,36 @@
 #include "shaderManager.h"
+#include "embeddedShaders.h"
+
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
+std::string ShaderManager::sourceDirectory;
 
 ShaderManager::~ShaderManager() {
     clear();
 }
 
+void ShaderManager::setSourceDirectory(const std::string& directory) {
+    sourceDirectory = directory;
+}
+
 Shader ShaderManager::loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name) {
-    return shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
+    // 1. retrieve the vertex/fragment source code
+    std::string vertexCode;
+    std::string fragmentCode;
+    std::string geometryCode;
+    Shader shader;
+    shader.ID = 0;
+    if (!getSource(vShaderFile, vertexCode) || !getSource(fShaderFile, fragmentCode) ||
+        (gShaderFile != nullptr && !getSource(gShaderFile, geometryCode))) {
+        std::cout << "ERROR::SHADER: Shader \"" << name << "\" not loaded" << std::endl;
+        return shaders[name] = shader;
+    }
+
+    // 2. now create shader object from source code
+    shader.compile(vertexCode.c_str(), fragmentCode.c_str(), gShaderFile != nullptr ? geometryCode.c_str() : nullptr);
+    return shaders[name] = shader;
 }
 
 Shader &ShaderManager::getShader(std::string name) {
@@ -22,42 +44,47 @@ void ShaderManager::clear() {
         glDeleteProgram(iter.second.ID);
 }
 
-Shader ShaderManager::loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile) {
-    // 1. retrieve the vertex/fragment source code from filePath
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::string geometryCode;
-    try {
-        // open files
-        std::ifstream vertexShaderFile(vShaderFile);
-        std::ifstream fragmentShaderFile(fShaderFile);
-        std::stringstream vShaderStream, fShaderStream;
-        // read file's buffer contents into streams
-        vShaderStream << vertexShaderFile.rdbuf();
-        fShaderStream << fragmentShaderFile.rdbuf();
-        // close file handlers
-        vertexShaderFile.close();
-        fragmentShaderFile.close();
-        // convert stream into string
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-        // if geometry shader path is present, also load a geometry shader
-        if (gShaderFile != nullptr) {
-            std::ifstream geometryShaderFile(gShaderFile);
-            std::stringstream gShaderStream;
-            gShaderStream << geometryShaderFile.rdbuf();
-            geometryShaderFile.close();
-            geometryCode = gShaderStream.str();
+bool ShaderManager::getSource(const char *fileName, std::string& source) {
+    // a file in the source directory overrides the embedded source
+    if (!sourceDirectory.empty()) {
+        std::string path = sourceDirectory + "/" + fileName;
+        if (std::ifstream(path).good()) {
+            if (!readSourceFile(path, source))
+                return false;
+            std::cout << "SHADER: Loaded " << path << std::endl;
+            return true;
         }
     }
-    catch (std::exception &e) {
-        std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
+
+    for (const EmbeddedShader& embedded : EMBEDDED_SHADERS) {
+        if (!strcmp(embedded.name, fileName)) {
+            source = embedded.source;
+            return true;
+        }
     }
-    const char *vShaderCode = vertexCode.c_str();
-    const char *fShaderCode = fragmentCode.c_str();
-    const char *gShaderCode = geometryCode.c_str();
-    // 2. now create shader object from source code
-    Shader shader;
-    shader.compile(vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
-    return shader;
-}
\ No newline at end of file
+    std::cout << "ERROR::SHADER: No shader file named " << fileName << " was embedded";
+    if (!sourceDirectory.empty())
+        std::cout << " or found in " << sourceDirectory;
+    std::cout << std::endl;
+    return false;
+}
+
+bool ShaderManager::readSourceFile(const std::string& path, std::string& source) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cout << "ERROR::SHADER: Could not open " << path << std::endl;
+        return false;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    if (file.bad()) {
+        std::cout << "ERROR::SHADER: Could not read " << path << std::endl;
+        return false;
+    }
+    source = stream.str();
+    if (source.empty()) {
+        std::cout << "ERROR::SHADER: " << path << " is empty" << std::endl;
+        return false;
+    }
+    return true;
+}
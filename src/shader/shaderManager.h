@@ -6,6 +6,10 @@
 #include <map>
 #include <iostream>
 
+/// @brief Loads, compiles and stores the shaders of the game by name.
+/// @details Shader sources are embedded into the binary at build time (see cmake/EmbedShaders.cmake), so loading
+///          needs no file I/O and works from any launch directory. During development a source directory can be
+///          set; shader files found there replace the embedded ones, so shaders can be edited without rebuilding.
 class ShaderManager {
 public:
     /// @brief Default constructor
@@ -15,12 +19,16 @@ public:
     ~ShaderManager();
 
 
-    /// @brief Calls loadShaderFromFile() and stores the shader in the shaders map
-    /// @param vShaderFile The vertex shader file
-    /// @param fShaderFile The fragment shader file
-    /// @param gShaderFile The geometry shader file (optional)
+    /// @brief Reads shader files from directory before falling back to the embedded sources
+    /// @param directory The directory to look in, empty to only use the embedded sources
+    static void setSourceDirectory(const std::string& directory);
+
+    /// @brief Finds the sources of a shader, compiles it and stores it in the shaders map
+    /// @param vShaderFile File name of the vertex shader (e.g. "shape.vert")
+    /// @param fShaderFile File name of the fragment shader
+    /// @param gShaderFile File name of the geometry shader (optional)
     /// @param name Name used for the shader in the shaders map
-    /// @return The shader that was loaded
+    /// @return The shader that was loaded (with ID 0 if a source could not be found)
     Shader loadShader(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile, std::string name);
 
     /// @brief Returns a reference to the shader with the given name in the shaders map
@@ -35,12 +43,18 @@ private:
     /// @brief A map of shaders, with the key being the name of the shader
     std::map<std::string, Shader> shaders;
 
-     /// @brief Loads and compiles a shader from a file
-     /// @details This function is private because we only want to load shaders from within this class
-     /// @param vShaderFile The vertex shader file
-     /// @param fShaderFile The fragment shader file
-     /// @param gShaderFile The geometry shader file (optional)
-     /// @return The shader that was loaded
-    Shader loadShaderFromFile(const char *vShaderFile, const char *fShaderFile, const char *gShaderFile=nullptr);};
+    /// @brief Directory shader files are read from before the embedded sources are used (empty for none)
+    static std::string sourceDirectory;
+
+    /// @brief Gets the source of a shader file, from the source directory if it is there, embedded otherwise
+    /// @param fileName The shader's file name
+    /// @param source Receives the source code
+    /// @return true if the source was found, false otherwise
+    static bool getSource(const char *fileName, std::string& source);
+
+    /// @brief Reads a shader file from disk
+    /// @return true if the file could be read, false otherwise
+    static bool readSourceFile(const std::string& path, std::string& source);
+};
 
 #endif //GRAPHICS_SHADERMANAGER_H
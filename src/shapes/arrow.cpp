@@ -29,11 +29,6 @@ Arrow::~Arrow() {
     glDeleteBuffers(1, &VBO);
 }
 
-void Arrow::draw() const {
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 9, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
 void Arrow::initVectorsQ1() { //Left
     this->vertices.insert(vertices.end(), {
             0.0f, 0.5f,  // Top left
@@ -102,10 +97,6 @@ void Arrow::initVectorsQ4() { //Up
     });
 }
 
-float Arrow::getTop() const         { return pos.y + (size.y /2); }
-float Arrow::getLeft() const        { return pos.x - (size.x / 2); }
-float Arrow::getRight() const       { return pos.x + (size.x /2); }
 float Arrow::getTip() const         { return pos.x + (+ (size.x /2) + 0.25f);}
-float Arrow::getBottom() const      { return pos.y - (size.y /2);}
 bool Arrow::getScored() const { return scored;}
 void Arrow::setScored(bool b) { scored = b;}
\ No newline at end of file
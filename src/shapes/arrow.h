@@ -38,15 +38,7 @@ public:
     /// @brief Destroy the Arrow object and delete it's VAO and VBO
     ~Arrow();
 
-    /// @brief Binds the VAO and calls the virtual draw function
-    void draw() const override;
-
-    float getTop() const override;
-    float getLeft() const override;
-// DONE: Implement getRight, getTop, and getBottom
-    float getRight() const override;
     float getTip() const;
-    float getBottom() const override;
     bool getScored() const;
     void setScored(bool b);
 
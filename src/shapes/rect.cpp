@@ -21,12 +21,6 @@ Rect::~Rect() {
     glDeleteBuffers(1, &VBO);
 }
 
-void Rect::draw() const {
-    glBindVertexArray(VAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
-
 void Rect::initVectors() {
     this->vertices.insert(vertices.end(), {
             // DONE: Add other three corners here
@@ -41,9 +35,3 @@ void Rect::initVectors() {
             1, 2, 3  // Second triangle
     });
 }
-// Overridden Getters from Shape
-float Rect::getLeft() const        { return pos.x - (size.x / 2); }
-// DONE: Implement getRight, getTop, and getBottom
-float Rect::getRight() const       { return pos.x + (size.x /2); }
-float Rect::getTop() const         { return pos.y + (size.y /2); }
-float Rect::getBottom() const      { return pos.y - (size.y /2); }
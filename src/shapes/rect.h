@@ -25,13 +25,6 @@ public:
     /// @brief Destroy the Square object and delete it's VAO and VBO
     ~Rect();
 
-    /// @brief Binds the VAO and calls the virtual draw function
-    void draw() const override;
-
-    float getLeft() const override;
-    float getRight() const override;
-    float getTop() const override;
-    float getBottom() const override;
 };
 
 
@@ -51,6 +51,12 @@ void Shape::setUniforms() const {
     this->shader.setVector4f("shapeColor", color.vec);
 }
 
+void Shape::draw() const {
+    glBindVertexArray(VAO);
+    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices.size()), GL_UNSIGNED_INT, 0);
+    glBindVertexArray(0);
+}
+
 bool Shape::isOverlapping(const vec2 &point) const {
     // DONE: Implement
     if (point[0] < getRight() && point[0] > getLeft() &&
@@ -63,25 +69,25 @@ bool Shape::isOverlapping(const vec2 &point) const {
     return false;
 }
 
-// Setters
-void Shape::move(vec2 offset)         { pos += offset; }
-void Shape::moveX(float x)            { pos.x += x; }
-void Shape::moveY(float y)            { pos.y += y; }
-void Shape::setPos(vec2 pos)          { this->pos = pos; }
-void Shape::setPosX(float x)          { pos.x = x; }
-void Shape::setPosY(float y)          { pos.y = y; }
-
-void Shape::setColor(struct color c)    { color = c; }
-void Shape::setColor(vec4 c)     { color.vec = c; }
-void Shape::setColor(vec3 c)     { color.vec = vec4(c, 1.0); }
-void Shape::setRed(float r)      { color.red = r; }
-void Shape::setGreen(float g)    { color.green = g; }
-void Shape::setBlue(float b)     { color.blue = b; }
-void Shape::setOpacity(float a)  { color.alpha = a; }
-
-void Shape::setSize(vec2 size) { this->size = size; }
-void Shape::setSizeX(float x)  { size.x = x; }
-void Shape::setSizeY(float y)  { size.y = y; }
+// Setters (each marks the shape dirty only if it actually changes it)
+void Shape::move(vec2 offset)         { dirty |= offset != vec2(0.0f); pos += offset; }
+void Shape::moveX(float x)            { dirty |= x != 0.0f; pos.x += x; }
+void Shape::moveY(float y)            { dirty |= y != 0.0f; pos.y += y; }
+void Shape::setPos(vec2 pos)          { dirty |= this->pos != pos; this->pos = pos; }
+void Shape::setPosX(float x)          { dirty |= pos.x != x; pos.x = x; }
+void Shape::setPosY(float y)          { dirty |= pos.y != y; pos.y = y; }
+
+void Shape::setColor(struct color c)    { setColor(c.vec); }
+void Shape::setColor(vec4 c)     { dirty |= color.vec != c; color.vec = c; }
+void Shape::setColor(vec3 c)     { setColor(vec4(c, 1.0)); }
+void Shape::setRed(float r)      { dirty |= color.red != r; color.red = r; }
+void Shape::setGreen(float g)    { dirty |= color.green != g; color.green = g; }
+void Shape::setBlue(float b)     { dirty |= color.blue != b; color.blue = b; }
+void Shape::setOpacity(float a)  { dirty |= color.alpha != a; color.alpha = a; }
+
+void Shape::setSize(vec2 size) { dirty |= this->size != size; this->size = size; }
+void Shape::setSizeX(float x)  { dirty |= size.x != x; size.x = x; }
+void Shape::setSizeY(float y)  { dirty |= size.y != y; size.y = y; }
 
 void move(vec2 deltaPos);
 void moveX(float deltaWidth);
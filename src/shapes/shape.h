@@ -47,10 +47,14 @@ public:
     float getPosX() const;
     float getPosY() const;
     vec2 getPos() const;
-    virtual float getLeft() const = 0;
-    virtual float getRight() const = 0;
-    virtual float getTop() const = 0;
-    virtual float getBottom() const = 0;
+
+    /// @brief Edges of the bounding box.
+    /// @details Every shape is centered on pos and spans size, so the edges are the same for all shapes and are
+    ///          inlined rather than looked up through the vtable.
+    float getLeft() const   { return pos.x - (size.x / 2); }
+    float getRight() const  { return pos.x + (size.x / 2); }
+    float getTop() const    { return pos.y + (size.y / 2); }
+    float getBottom() const { return pos.y - (size.y / 2); }
 
     // Color Functions
     vec4 getColor4() const;
@@ -102,20 +106,27 @@ public:
     void setBlue(float b);
     void setOpacity(float a);
 
+    /// @brief Returns true if a setter changed the shape since clearDirty()
+    /// @details Lets drawings cached from the shape (StaticLayer) tell when they are out of date. Setters that set
+    ///          a value the shape already has do not count as changes.
+    bool isDirty() const { return dirty; }
+    void clearDirty() { dirty = false; }
+
     // --------------------------------------------------------
     // Collision functions
     // --------------------------------------------------------
-    virtual bool isOverlapping(const vec2& point) const;
+    bool isOverlapping(const vec2& point) const;
 
     // --------------------------------------------------------
     // Drawing functions
     // --------------------------------------------------------
 
-    /// @brief Sets the uniform variables from members, and calls the virtual draw function
+    /// @brief Sets the uniform variables from members
     void setUniforms() const;
 
-    /// @brief Pure virtual function to draw the shape.
-    virtual void draw() const = 0;
+    /// @brief Binds the VAO and draws all of the shape's indices.
+    /// @details Shapes differ only in their vertex data, so drawing needs no per-type dispatch.
+    void draw() const;
 
 protected:
     /// @brief Shader used to draw all abstract shapes.
@@ -139,6 +150,9 @@ protected:
 
     /// @brief The indices of the shape
     vector<unsigned int> indices;
+
+    /// @brief Set when position, size or color change, see isDirty()
+    bool dirty = true;
 };
 
 #endif //GRAPHICS_SHAPE_H
@@ -15,12 +15,6 @@ Triangle::~Triangle() {
     glDeleteBuffers(1, &EBO);
 }
 
-void Triangle::draw() const {
-    glBindVertexArray(this->VAO);
-    glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
-
 void Triangle::initVectors() {
     this->vertices.insert(this->vertices.end(), {
             -0.5f, -0.5f,  // Bottom left
@@ -33,11 +27,6 @@ void Triangle::initVectors() {
     });
 }
 
-float Triangle::getLeft() const     { return pos.x - (size.x / 2); }
-float Triangle::getRight() const    { return pos.x + (size.x / 2); }
-float Triangle::getTop() const      { return pos.y + (size.y / 2); }
-float Triangle::getBottom() const   { return pos.y - (size.y / 2); }
-
 // Is the shape overlapping the top point?
 bool Triangle::isOverlapping(const Shape &other) const {
     return other.getLeft() <= pos.x && other.getRight() >= pos.x &&
@@ -19,17 +19,9 @@ public:
     /// @brief Destroy the Triangle object and delete its VAO and VBO
     ~Triangle();
 
-    /// @brief Binds the VAO and calls the virtual draw function
-    void draw() const override;
-
     /// @brief Populates the vertices and indices vectors
     void initVectors();
 
-    float getLeft() const override;
-    float getRight() const override;
-    float getTop() const override;
-    float getBottom() const override;
-
     bool isOverlapping(const Shape& other) const;
 };
 
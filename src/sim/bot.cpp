@@ -0,0 +1,47 @@
+#include "bot.h"
+
+#include <algorithm>
+
+Bot::Bot(const BotConfig& config, uint64_t seed) : config(config), random(seed), target() {}
+
+uint8_t Bot::decide(Session& session) {
+    if (session.getScreen() == SCREEN_START)
+        return BUTTON_START;
+    if (session.getScreen() != SCREEN_PLAY)
+        return 0;
+
+    const ArrowField& arrows = session.getArrows();
+    double now = session.getTick() * session.getStepTime();
+    uint8_t buttons = 0;
+
+    for (int lane = 0; lane < LANE_COUNT; lane++) {
+        ArrowHandle front;
+        bool hasFront = session.getLaneFront(static_cast<Lane>(lane), front);
+
+        // a new arrow is the lane's next: draw the reaction time and timing error for it
+        if (hasFront && (!hasTarget[lane] || front.slot != target[lane].slot ||
+                         front.generation != target[lane].generation)) {
+            target[lane] = front;
+            hasTarget[lane] = true;
+            pressed[lane] = false;
+            double seen = arrows.getSpawnTime()[arrows.indexOf(front)];
+            earliest[lane] = seen + std::max(0.0, random.nextGaussian(config.reactionMean, config.reactionStdDev));
+            timingError[lane] = random.nextGaussian(0.0, config.timingStdDev);
+        }
+
+        // the arrow is tracked every step, so a speed up while it falls is accounted for
+        bool due = false;
+        if (hasFront && !pressed[lane] && now >= earliest[lane]) {
+            due = session.timingOffset(static_cast<Lane>(lane), arrows.indexOf(front)) <= -timingError[lane];
+        }
+
+        if (due) {
+            pressed[lane] = true;
+            releaseAt[lane] = now + config.holdTime;
+            buttons |= 1 << lane;
+        } else if (now < releaseAt[lane]) {
+            buttons |= 1 << lane;
+        }
+    }
+    return buttons;
+}
@@ -0,0 +1,49 @@
+#ifndef GRAPHICS_BOT_H
+#define GRAPHICS_BOT_H
+
+#include <cstdint>
+
+#include "../game/session.h"
+#include "../util/random.h"
+
+/// @brief How a bot player reacts and how precise its timing is. All times are in seconds.
+struct BotConfig {
+    /// @brief Mean and standard deviation of the time from an arrow appearing until the bot can press for it
+    double reactionMean = 0.25, reactionStdDev = 0.05;
+
+    /// @brief Standard deviation of a press around the moment the arrow is centered on the marker
+    double timingStdDev = 0.03;
+
+    /// @brief How long a press is held (0 releases after one step)
+    double holdTime = 0.0;
+};
+
+/**
+ * @brief A simulated player
+ * @details Watches the lowest arrow of every lane like a player would and presses once per arrow: when the
+ * arrow reaches its marker, off by a normally distributed timing error, but never before its reaction time has
+ * passed. The bot has its own random generator, so it does not disturb the session's spawn sequence.
+ */
+class Bot {
+public:
+    /// @brief Construct a new Bot object
+    /// @param config Reaction and timing distributions
+    /// @param seed Seed of the bot's random generator
+    Bot(const BotConfig& config, uint64_t seed);
+
+    /// @brief Returns the buttons to hold during the session's next step
+    uint8_t decide(Session& session);
+
+private:
+    BotConfig config;
+    Random random;
+
+    /// @brief Per lane, the arrow the current plan is for, whether it was pressed for, the earliest the bot can
+    ///        react, its timing error, and when to let go of the last press.
+    ArrowHandle target[LANE_COUNT];
+    bool hasTarget[LANE_COUNT] = {};
+    bool pressed[LANE_COUNT] = {};
+    double earliest[LANE_COUNT] = {}, timingError[LANE_COUNT] = {}, releaseAt[LANE_COUNT] = {};
+};
+
+#endif //GRAPHICS_BOT_H
@@ -0,0 +1,112 @@
+#include "botSimulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#include "../jobs/jobSystem.h"
+
+/// Most rows the score histogram is printed with; buckets are multiples of 50 points wide
+static const int HISTOGRAM_ROWS = 20;
+
+/// Returns the value at quantile q of sorted values
+static double percentile(const vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    size_t i = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+/// Prints mean and percentiles of values (sorted in place)
+static void printDistribution(const char* name, vector<double>& values, const char* unit) {
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double value : values) sum += value;
+    printf("  %-16s mean %10.2f  p10 %10.2f  p50 %10.2f  p90 %10.2f  p99 %10.2f  max %10.2f %s\n", name,
+           values.empty() ? 0.0 : sum / values.size(), percentile(values, 0.10), percentile(values, 0.50),
+           percentile(values, 0.90), percentile(values, 0.99), values.empty() ? 0.0 : values.back(), unit);
+}
+
+BotSimulator::BotSimulator(const SimulatorConfig& config) : config(config) {
+    threadCount = config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min<unsigned int>(threadCount, std::max<uint32_t>(config.sessions, 1));
+}
+
+bool BotSimulator::run() {
+    // fail once up front rather than once per session
+    if (!config.chartPath.empty() && !ChartStream().open(config.chartPath))
+        return false;
+
+    results.assign(config.sessions, SessionResult());
+    JobSystem jobs(threadCount);
+
+    // one session per job, sessions vary in length so idle threads steal the rest
+    auto start = std::chrono::steady_clock::now();
+    jobs.parallelFor(config.sessions, 1, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            results[i] = runSession(static_cast<uint32_t>(i));
+    });
+    wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return true;
+}
+
+SessionResult BotSimulator::runSession(uint32_t index) const {
+    EngineConfig engineConfig = config.engine;
+    engineConfig.seed += index;
+    Session session(engineConfig);
+    if (!config.chartPath.empty())
+        session.loadChart(config.chartPath);
+    Bot bot(config.bot, engineConfig.seed ^ 0xB07B07B07B07B07Bull);
+
+    auto start = std::chrono::steady_clock::now();
+    while (session.getScreen() != SCREEN_OVER && session.getPlayTime() < config.maxSeconds)
+        session.step(bot.decide(session));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    SessionResult result;
+    result.survivalTime = session.getPlayTime();
+    result.score = session.getScore();
+    result.ticks = session.getTick();
+    result.nsPerTick = result.ticks > 0 ? seconds * 1e9 / result.ticks : 0.0;
+    result.survived = session.getScreen() != SCREEN_OVER;
+    return result;
+}
+
+void BotSimulator::report() const {
+    vector<double> survival, scores, cost;
+    uint64_t ticks = 0;
+    uint32_t survived = 0;
+    int maxScore = 0;
+    for (const SessionResult& result : results) {
+        survival.push_back(result.survivalTime);
+        scores.push_back(result.score);
+        cost.push_back(result.nsPerTick);
+        ticks += result.ticks;
+        survived += result.survived;
+        maxScore = std::max(maxScore, result.score);
+    }
+
+    const BotConfig& bot = config.bot;
+    printf("SIM: %u sessions on %u threads in %.2f s (%.1f M steps/s), base seed %llu, %.0f Hz\n",
+           config.sessions, threadCount, wallSeconds, wallSeconds > 0 ? ticks / wallSeconds / 1e6 : 0.0,
+           static_cast<unsigned long long>(config.engine.seed), config.engine.simRate);
+    printf("SIM: bot reaction %.0f +- %.0f ms, timing error %.0f ms, hold %.0f ms\n", bot.reactionMean * 1000,
+           bot.reactionStdDev * 1000, bot.timingStdDev * 1000, bot.holdTime * 1000);
+    printDistribution("survival", survival, "s");
+    printDistribution("score", scores, "");
+    printDistribution("step cost", cost, "ns");
+    printf("  %u sessions (%.1f%%) survived the %.0f s limit\n", survived,
+           results.empty() ? 0.0 : 100.0 * survived / results.size(), config.maxSeconds);
+
+    // score histogram
+    int bucketWidth = (maxScore / HISTOGRAM_ROWS / 50 + 1) * 50;
+    vector<uint32_t> buckets(maxScore / bucketWidth + 1, 0);
+    for (const SessionResult& result : results)
+        buckets[result.score / bucketWidth]++;
+    uint32_t largest = *std::max_element(buckets.begin(), buckets.end());
+    for (size_t i = 0; i < buckets.size(); i++) {
+        int bar = largest > 0 ? static_cast<int>(40.0 * buckets[i] / largest + 0.5) : 0;
+        printf("  score %6zu-%-6zu %7u %s\n", i * bucketWidth, (i + 1) * bucketWidth - 1, buckets[i],
+               string(bar, '#').c_str());
+    }
+}
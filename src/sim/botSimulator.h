@@ -0,0 +1,78 @@
+#ifndef GRAPHICS_BOTSIMULATOR_H
+#define GRAPHICS_BOTSIMULATOR_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../engineConfig.h"
+#include "bot.h"
+
+using std::string, std::vector;
+
+/// @brief What the bot simulator runs.
+struct SimulatorConfig {
+    /// @brief Number of sessions to play
+    uint32_t sessions = 1000;
+
+    /// @brief Number of worker threads (0 uses every core)
+    unsigned int threads = 0;
+
+    /// @brief Seconds of play after which a session is stopped as survived
+    double maxSeconds = 600.0;
+
+    /// @brief Configuration of every session; session i is seeded with engine.seed + i
+    EngineConfig engine;
+
+    /// @brief How the bots play
+    BotConfig bot;
+
+    /// @brief Chart to play instead of the random spawner (empty for none)
+    string chartPath;
+};
+
+/// @brief Outcome of one simulated session.
+struct SessionResult {
+    /// @brief Seconds of play until game over (or maxSeconds)
+    double survivalTime;
+    int score;
+    uint32_t ticks;
+    /// @brief Wall time per step, including the bot's decision, in nanoseconds
+    double nsPerTick;
+    /// @brief True if the session was stopped at maxSeconds rather than lost
+    bool survived;
+};
+
+/**
+ * @brief Plays many headless sessions with bots, spread over all cores, and summarizes the results
+ * @details Every session owns its own Session and Bot and runs as a job of a JobSystem; a job writes its result to
+ * its own slot, so no game state is shared between threads. Results depend only on the
+ * configuration, not on the thread count.
+ */
+class BotSimulator {
+public:
+    explicit BotSimulator(const SimulatorConfig& config);
+
+    /// @brief Plays all sessions
+    /// @return false if the chart could not be loaded
+    bool run();
+
+    /// @brief Prints survival time, score and per-step cost distributions to stdout
+    void report() const;
+
+    const vector<SessionResult>& getResults() const { return results; }
+
+    /// @brief Returns the wall time run() took in seconds
+    double getWallSeconds() const { return wallSeconds; }
+
+private:
+    /// @brief Plays session index to the end
+    SessionResult runSession(uint32_t index) const;
+
+    SimulatorConfig config;
+    vector<SessionResult> results;
+    unsigned int threadCount = 1;
+    double wallSeconds = 0.0;
+};
+
+#endif //GRAPHICS_BOTSIMULATOR_H
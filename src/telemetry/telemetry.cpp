@@ -0,0 +1,121 @@
+#include "telemetry.h"
+#include "../util/binaryIO.h"
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using std::cout, std::endl;
+
+static const char MAGIC[4] = {'A', 'D', 'T', 'L'};
+static const uint16_t VERSION = 1;
+
+/// How long the writer sleeps when the ring is empty
+static const std::chrono::milliseconds IDLE_SLEEP(5);
+
+/// How often the log is synced to disk
+static const std::chrono::seconds SYNC_INTERVAL(1);
+
+TelemetryWriter::TelemetryWriter(size_t capacity) : ring(capacity) {
+    batch.resize(ring.capacity());
+}
+
+TelemetryWriter::~TelemetryWriter() {
+    close();
+}
+
+bool TelemetryWriter::open(const string& path, const EngineConfig& config) {
+    close();
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        cout << "ERROR::TELEMETRY: Could not open " << path << " for writing" << endl;
+        return false;
+    }
+    this->path = path;
+
+    std::ostringstream header;
+    header.write(MAGIC, sizeof(MAGIC));
+    writeLE<uint16_t>(header, VERSION);
+    writeLE<uint16_t>(header, sizeof(TelemetryRecord));
+    writeLE<uint64_t>(header, config.seed);
+    writeLE<float>(header, config.simRate);
+    writeLE<float>(header, config.startSpeed);
+    string bytes = header.str();
+    std::fwrite(bytes.data(), 1, bytes.size(), file);
+
+    written = 0;
+    droppedLogged = 0;
+    dropped = 0;
+    running = true;
+    writer = std::thread(&TelemetryWriter::run, this);
+    return true;
+}
+
+void TelemetryWriter::close() {
+    if (!file)
+        return;
+    running = false;
+    writer.join();
+
+    // the thread has stopped, pick up whatever was pushed after its last pass
+    drain();
+    sync();
+    std::fclose(file);
+    file = nullptr;
+    cout << "TELEMETRY: Wrote " << written << " records to " << path << ", dropped " << getDropped() << endl;
+}
+
+void TelemetryWriter::run() {
+    auto lastSync = std::chrono::steady_clock::now();
+    while (running.load(std::memory_order_acquire)) {
+        size_t count = drain();
+
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastSync >= SYNC_INTERVAL) {
+            sync();
+            lastSync = now;
+        }
+        // a full batch means the game is producing fast, go straight back for more
+        if (count < batch.size())
+            std::this_thread::sleep_for(IDLE_SLEEP);
+    }
+}
+
+size_t TelemetryWriter::drain() {
+    size_t count = 0;
+    while (count < batch.size() && ring.pop(batch[count]))
+        count++;
+
+    if (count > 0) {
+        std::fwrite(batch.data(), sizeof(TelemetryRecord), count, file);
+        written += count;
+    }
+
+    // the log records where it has gaps
+    uint64_t droppedNow = getDropped();
+    if (droppedNow != droppedLogged) {
+        TelemetryRecord gap = {};
+        gap.tick = count > 0 ? batch[count - 1].tick : 0;
+        gap.type = TELEMETRY_DROPPED;
+        gap.value = static_cast<float>(droppedNow - droppedLogged);
+        std::fwrite(&gap, sizeof(gap), 1, file);
+        written++;
+        droppedLogged = droppedNow;
+    }
+    return count;
+}
+
+void TelemetryWriter::sync() {
+    std::fflush(file);
+#ifdef _WIN32
+    _commit(_fileno(file));
+#else
+    fsync(fileno(file));
+#endif
+}
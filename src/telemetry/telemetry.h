@@ -0,0 +1,106 @@
+#ifndef GRAPHICS_TELEMETRY_H
+#define GRAPHICS_TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../engineConfig.h"
+#include "../util/spscRing.h"
+
+using std::string;
+
+/// @brief What a telemetry record describes.
+enum TelemetryType : uint8_t {
+    /// @brief The play screen was entered
+    TELEMETRY_START,
+    /// @brief A lane button went down; value is the press timing offset in seconds to the lane's next arrow
+    ///        (positive is early, NaN if the lane had none)
+    TELEMETRY_PRESS,
+    /// @brief An arrow was scored; value is the press timing offset in seconds (positive is early)
+    TELEMETRY_HIT,
+    /// @brief An arrow left its hit window unscored
+    TELEMETRY_MISS,
+    /// @brief The fall speed changed; value is the new speed
+    TELEMETRY_SPEED,
+    /// @brief The game is over; score is the final score
+    TELEMETRY_END,
+    /// @brief Written by the writer itself; value is the number of records dropped since the last one
+    TELEMETRY_DROPPED
+};
+
+/// @brief One fixed-size telemetry record, written to the log as is (16 bytes, host byte order).
+struct TelemetryRecord {
+    uint32_t tick;
+    TelemetryType type;
+    uint8_t lane;
+    uint16_t reserved;
+    float value;
+    int32_t score;
+};
+static_assert(sizeof(TelemetryRecord) == 16, "telemetry records are written to disk as is");
+
+/**
+ * @brief Writes telemetry records to a binary log on a background thread
+ * @details The game thread only copies records into a lock-free ring, so logging never blocks a step. When the ring
+ * is full, records are dropped and counted rather than waited for; the writer logs a TELEMETRY_DROPPED record with
+ * the count, and the total is reported on close. The writer thread drains the ring in batches and flushes the file
+ * to disk about once a second, so a crash loses at most the last second.
+ *
+ * Log format: "ADTL", u16 version, u16 record size, u64 seed, f32 sim rate, f32 start speed, then records.
+ */
+class TelemetryWriter {
+public:
+    /// @brief Construct a new Telemetry Writer object
+    /// @param capacity Number of records the ring buffers between the game and the writer thread
+    explicit TelemetryWriter(size_t capacity = 8192);
+
+    /// @brief Flushes the remaining records and closes the log.
+    ~TelemetryWriter();
+
+    /// @brief Creates the log and starts the writer thread
+    /// @param path The file to write
+    /// @param config The session's configuration, stored in the header
+    /// @return true if the file could be created, false otherwise
+    bool open(const string& path, const EngineConfig& config);
+
+    /// @brief Writes the remaining records, syncs the file and stops the writer thread
+    void close();
+
+    /// @brief Queues a record (game thread only); never blocks
+    /// @return false if the ring was full and the record was dropped
+    bool push(const TelemetryRecord& record) {
+        if (ring.push(record))
+            return true;
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /// @brief Returns the number of records dropped so far
+    uint64_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    /// @brief Body of the writer thread
+    void run();
+
+    /// @brief Writes everything queued so far, returns the number of records written
+    size_t drain();
+
+    /// @brief Flushes the file and asks the OS to put it on disk
+    void sync();
+
+    SpscRing<TelemetryRecord> ring;
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> running{false};
+    std::thread writer;
+
+    FILE* file = nullptr;
+    string path;
+    std::vector<TelemetryRecord> batch;
+    uint64_t written = 0, droppedLogged = 0;
+};
+
+#endif //GRAPHICS_TELEMETRY_H
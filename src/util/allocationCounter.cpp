@@ -0,0 +1,86 @@
+#include "allocationCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+// Plain integers: every thread only touches its own counters, and they need no construction
+static thread_local uint64_t threadAllocations = 0;
+static thread_local uint64_t threadAllocatedBytes = 0;
+
+uint64_t getThreadAllocations() { return threadAllocations; }
+
+uint64_t getThreadAllocatedBytes() { return threadAllocatedBytes; }
+
+/// @brief Counts and performs one allocation, returns nullptr on failure
+static void* countedAlloc(std::size_t size) {
+    threadAllocations++;
+    threadAllocatedBytes += size;
+    return std::malloc(size ? size : 1);
+}
+
+/// @brief Counts and performs one over-aligned allocation, returns nullptr on failure
+static void* countedAlignedAlloc(std::size_t size, std::size_t align) {
+    threadAllocations++;
+    threadAllocatedBytes += size;
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc wants a size that is a multiple of the alignment
+    size = (size + align - 1) & ~(align - 1);
+    return std::aligned_alloc(align, size ? size : align);
+#endif
+}
+
+static void alignedFree(void* p) {
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+// --------------------------------------------------------
+// Replacements of the global allocation functions
+// --------------------------------------------------------
+
+void* operator new(std::size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new(std::size_t size, std::align_val_t align) {
+    void* p = countedAlignedAlloc(size, static_cast<std::size_t>(align));
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) { return operator new(size, align); }
+
+void* operator new(std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return countedAlignedAlloc(size, static_cast<std::size_t>(align));
+}
+
+void* operator new[](std::size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return countedAlignedAlloc(size, static_cast<std::size_t>(align));
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
@@ -0,0 +1,23 @@
+#ifndef GRAPHICS_ALLOCATIONCOUNTER_H
+#define GRAPHICS_ALLOCATIONCOUNTER_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * Heap allocation accounting
+ *
+ * allocationCounter.cpp replaces the global operator new and delete of the program with versions that
+ * forward to malloc and free and count every allocation made by the calling thread. Reading the counter before
+ * and after a piece of code tells how often it allocated, which is how --check-allocations verifies that a
+ * steady state frame allocates nothing. Memory allocated with malloc directly (e.g. inside C libraries) is not
+ * counted.
+ */
+
+/// @brief Returns the number of operator new calls made by the calling thread so far
+uint64_t getThreadAllocations();
+
+/// @brief Returns the number of bytes requested through operator new by the calling thread so far
+uint64_t getThreadAllocatedBytes();
+
+#endif //GRAPHICS_ALLOCATIONCOUNTER_H
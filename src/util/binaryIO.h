@@ -0,0 +1,101 @@
+#ifndef GRAPHICS_BINARYIO_H
+#define GRAPHICS_BINARYIO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+// Helpers to write/read fixed size little endian values and varints, so files are portable between machines.
+
+/// @brief Writes a trivially copyable value as little endian bytes
+template <typename T>
+void writeLE(std::ostream& out, T value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++)
+        out.put(static_cast<char>((bits >> (8 * i)) & 0xFF));
+}
+
+/// @brief Reads a value written by writeLE()
+/// @return false if the stream ended first
+template <typename T>
+bool readLE(std::istream& in, T& value) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        int byte = in.get();
+        if (byte == EOF) return false;
+        bits |= static_cast<uint64_t>(byte) << (8 * i);
+    }
+    std::memcpy(&value, &bits, sizeof(T));
+    return true;
+}
+
+/// @brief Reads a value written by writeLE() from memory
+template <typename T>
+T loadLE(const uint8_t* data) {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < sizeof(T); i++)
+        bits |= static_cast<uint64_t>(data[i]) << (8 * i);
+    T value;
+    std::memcpy(&value, &bits, sizeof(T));
+    return value;
+}
+
+/// @brief Appends a trivially copyable value to a byte buffer as little endian bytes
+template <typename T>
+void appendLE(std::vector<uint8_t>& out, T value) {
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(T));
+    for (size_t i = 0; i < sizeof(T); i++)
+        out.push_back(static_cast<uint8_t>((bits >> (8 * i)) & 0xFF));
+}
+
+/// @brief Appends an unsigned integer to a byte buffer in the format of writeVarint()
+inline void appendVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+/// @brief Writes an unsigned integer in 7 bit groups, low first (1 byte for values below 128)
+inline void writeVarint(std::ostream& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.put(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.put(static_cast<char>(value));
+}
+
+/// @brief Reads a value written by writeVarint()
+/// @return false if the stream ended first or the value is malformed
+inline bool readVarint(std::istream& in, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        int byte = in.get();
+        if (byte == EOF) return false;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+/// @brief Reads a value written by writeVarint() from memory
+/// @param data Read position, advanced past the value
+/// @param end End of the readable memory
+/// @return false if the memory ended first or the value is malformed
+inline bool decodeVarint(const uint8_t*& data, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && data < end; shift += 7) {
+        uint8_t byte = *data++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+#endif //GRAPHICS_BINARYIO_H
@@ -0,0 +1,89 @@
+#ifndef GRAPHICS_FRAMEARENA_H
+#define GRAPHICS_FRAMEARENA_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string_view>
+
+/**
+ * @brief Linear allocator for data that only lives until the end of a frame
+ * @details Memory is taken from one block allocated up front by bumping an offset, and reset() hands all of it
+ * back at once at the start of the next frame. Nothing is freed individually and no destructors run, so only
+ * trivially destructible data belongs here. When the block is used up, allocate() returns nullptr instead of
+ * going to the heap, and the overflow is counted so a too small arena shows up in the statistics.
+ */
+class FrameArena {
+public:
+    /// @brief Construct a new Frame Arena object
+    /// @param capacity Bytes available per frame
+    explicit FrameArena(size_t capacity = 64 * 1024) : buffer(new unsigned char[capacity]), size(capacity) {}
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    /// @brief Returns size bytes aligned to align (a power of two), or nullptr if the arena is full
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        uintptr_t base = reinterpret_cast<uintptr_t>(buffer.get());
+        size_t start = ((base + offset + align - 1) & ~(uintptr_t(align) - 1)) - base;
+        if (start + bytes > size) {
+            overflows++;
+            return nullptr;
+        }
+        offset = start + bytes;
+        if (offset > peak) peak = offset;
+        return buffer.get() + start;
+    }
+
+    /// @brief Returns an uninitialized array of count T, or nullptr if the arena is full
+    template <typename T>
+    T* allocateArray(size_t count) { return static_cast<T*>(allocate(sizeof(T) * count, alignof(T))); }
+
+    /// @brief Formats a string into the arena (printf syntax)
+    /// @return The formatted text, valid until reset(); truncated to what fits if the arena is almost full
+    std::string_view format(const char* fmt, ...) {
+        size_t available = size - offset;
+        if (available == 0) {
+            overflows++;
+            return {};
+        }
+        char* text = reinterpret_cast<char*>(buffer.get() + offset);
+        va_list args;
+        va_start(args, fmt);
+        int length = std::vsnprintf(text, available, fmt, args);
+        va_end(args);
+        if (length < 0)
+            return {};
+        if (static_cast<size_t>(length) >= available) {
+            overflows++;
+            length = static_cast<int>(available - 1);
+        }
+        offset += length + 1;
+        if (offset > peak) peak = offset;
+        return {text, static_cast<size_t>(length)};
+    }
+
+    /// @brief Releases everything allocated since the last reset
+    void reset() { offset = 0; }
+
+    /// @brief Returns the bytes in use this frame
+    size_t used() const { return offset; }
+
+    /// @brief Returns the most bytes ever in use in one frame
+    size_t highWater() const { return peak; }
+
+    /// @brief Returns the bytes available per frame
+    size_t capacity() const { return size; }
+
+    /// @brief Returns how many allocations did not fit
+    size_t getOverflows() const { return overflows; }
+
+private:
+    std::unique_ptr<unsigned char[]> buffer;
+    size_t size;
+    size_t offset = 0, peak = 0, overflows = 0;
+};
+
+#endif //GRAPHICS_FRAMEARENA_H
@@ -0,0 +1,35 @@
+#ifndef GRAPHICS_HASH_H
+#define GRAPHICS_HASH_H
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/// @brief Incremental 64-bit FNV-1a hash.
+/// @details Used to fingerprint the game state each tick so two runs can be compared bit-for-bit.
+class Hash {
+public:
+    /// @brief Adds raw bytes to the hash
+    void add(const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            value ^= bytes[i];
+            value *= 0x100000001B3ull;
+        }
+    }
+
+    /// @brief Adds the object representation of a trivially copyable value to the hash
+    template <typename T>
+    void add(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "Hash::add needs a trivially copyable type");
+        add(&v, sizeof(T));
+    }
+
+    /// @brief Returns the current hash value
+    uint64_t get() const { return value; }
+
+private:
+    uint64_t value = 0xCBF29CE484222325ull;
+};
+
+#endif //GRAPHICS_HASH_H
@@ -0,0 +1,132 @@
+#include "mappedFile.h"
+
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cout << "ERROR::MAPPEDFILE: Could not open " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file, &fileSize);
+    if (fileSize.QuadPart == 0) {
+        // an empty file cannot be mapped, but it is a valid (empty) mapping for our purposes
+        CloseHandle(file);
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cout << "ERROR::MAPPEDFILE: Could not map " << path << std::endl;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    data = static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cout << "ERROR::MAPPEDFILE: Could not open " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::cout << "ERROR::MAPPEDFILE: Could not stat " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    if (info.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    // the mapping keeps the file alive, the descriptor is no longer needed
+    ::close(fd);
+    if (view == MAP_FAILED) {
+        std::cout << "ERROR::MAPPEDFILE: Could not map " << path << std::endl;
+        return false;
+    }
+    data = static_cast<const uint8_t*>(view);
+    size = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+#else
+    if (data) munmap(const_cast<uint8_t*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+void MappedFile::adviseSequential() const {
+#ifndef _WIN32
+    if (data) madvise(const_cast<uint8_t*>(data), size, MADV_SEQUENTIAL);
+#endif
+}
+
+void MappedFile::prefetch(size_t offset, size_t length) const {
+    if (!data || offset >= size) return;
+    if (length > size - offset) length = size - offset;
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range = {const_cast<uint8_t*>(data) + offset, length};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise needs a page aligned start
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t begin = offset / page * page;
+    madvise(const_cast<uint8_t*>(data) + begin, offset + length - begin, MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::release(size_t offset, size_t length) const {
+    if (!data || offset >= size) return;
+    if (length > size - offset) length = size - offset;
+
+    // only whole pages can be dropped
+#ifdef _WIN32
+    SYSTEM_INFO system;
+    GetSystemInfo(&system);
+    size_t page = system.dwPageSize;
+#else
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    size_t begin = (offset + page - 1) / page * page;
+    size_t end = (offset + length) / page * page;
+    if (end <= begin) return;
+
+#ifdef _WIN32
+    // unlocking pages that are not locked removes them from the working set
+    VirtualUnlock(const_cast<uint8_t*>(data) + begin, end - begin);
+#else
+    madvise(const_cast<uint8_t*>(data) + begin, end - begin, MADV_DONTNEED);
+#endif
+}
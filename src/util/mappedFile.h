@@ -0,0 +1,56 @@
+#ifndef GRAPHICS_MAPPEDFILE_H
+#define GRAPHICS_MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief A file mapped read-only into memory
+ * @details Pages are loaded by the OS on first access, so opening is cheap whatever the file size. Readers that
+ * stream through a file can hand pages they are done with back with release(), keeping resident memory bounded.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    /// @brief Unmaps the file
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// @brief Maps a file, unmapping the current one
+    /// @return true if successful, false otherwise
+    bool open(const std::string& path);
+
+    /// @brief Unmaps the file
+    void close();
+
+    /// @brief Returns the start of the mapping (nullptr if nothing is mapped)
+    const uint8_t* getData() const { return data; }
+
+    /// @brief Returns the size of the file in bytes
+    size_t getSize() const { return size; }
+
+    /// @brief Tells the OS the file will be read front to back, so it can read ahead
+    void adviseSequential() const;
+
+    /// @brief Asks the OS to start loading [offset, offset + length) in the background
+    void prefetch(size_t offset, size_t length) const;
+
+    /// @brief Drops the resident pages fully inside [offset, offset + length)
+    /// @details The data is still mapped; touching it again reloads it from the file.
+    void release(size_t offset, size_t length) const;
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif //GRAPHICS_MAPPEDFILE_H
@@ -0,0 +1,56 @@
+#ifndef GRAPHICS_RANDOM_H
+#define GRAPHICS_RANDOM_H
+
+#include <cmath>
+#include <cstdint>
+
+/// @brief Small, fast, seedable pseudo random number generator (xorshift64*).
+/// @details Unlike rand(), the sequence depends only on the seed and is the same on every platform,
+///          so recording the seed is enough to reproduce every random decision of a session.
+class Random {
+public:
+    /// @brief Construct a new Random object
+    /// @param seed The seed of the sequence
+    explicit Random(uint64_t seed = 1) { setSeed(seed); }
+
+    /// @brief Restarts the sequence from the given seed
+    /// @details The seed is scrambled with splitmix64 so that nearby seeds give unrelated sequences.
+    void setSeed(uint64_t seed) {
+        uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        state = z ^ (z >> 31);
+        if (state == 0) state = 0x9E3779B97F4A7C15ull; // xorshift must never hold a zero state
+    }
+
+    /// @brief Returns the next 64 random bits
+    uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1Dull;
+    }
+
+    /// @brief Returns a random integer in [0, bound)
+    uint32_t nextInt(uint32_t bound) { return static_cast<uint32_t>(((next() >> 32) * bound) >> 32); }
+
+    /// @brief Returns a random float in [0, 1)
+    float nextFloat() { return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f); }
+
+    /// @brief Returns a normally distributed random number (Box-Muller)
+    /// @param mean The mean of the distribution
+    /// @param stdDev The standard deviation of the distribution
+    double nextGaussian(double mean = 0.0, double stdDev = 1.0) {
+        double u1 = (static_cast<double>(next() >> 11) + 1.0) * (1.0 / 9007199254740992.0); // (0, 1], log-safe
+        double u2 = static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+        return mean + stdDev * std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    }
+
+    /// @brief Returns the internal state (used for state hashing)
+    uint64_t getState() const { return state; }
+
+private:
+    uint64_t state;
+};
+
+#endif //GRAPHICS_RANDOM_H
@@ -0,0 +1,71 @@
+#ifndef GRAPHICS_SPSCRING_H
+#define GRAPHICS_SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Bounded lock-free queue for exactly one producer thread and one consumer thread
+ * @details push() and pop() never block and never allocate: a full ring makes push() fail, an empty one makes
+ * pop() fail, and the caller decides what to do. Head and tail sit on separate cache lines so the two threads do
+ * not invalidate each other's line on every operation.
+ * @tparam T A trivially copyable element type
+ */
+template <typename T>
+class SpscRing {
+public:
+    /// @brief Construct a new Spsc Ring object
+    /// @param capacity Number of elements the ring holds (rounded up to a power of two)
+    explicit SpscRing(size_t capacity = 1024) {
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    /// @brief Appends an element (producer thread only)
+    /// @return false if the ring is full
+    bool push(const T& value) {
+        size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - cachedHead > mask) {
+            cachedHead = head.load(std::memory_order_acquire);
+            if (tail - cachedHead > mask)
+                return false;
+        }
+        slots[tail & mask] = value;
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Removes the oldest element (consumer thread only)
+    /// @return false if the ring is empty
+    bool pop(T& value) {
+        size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == cachedTail) {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (head == cachedTail)
+                return false;
+        }
+        value = slots[head & mask];
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Returns the number of elements the ring holds
+    size_t capacity() const { return mask + 1; }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+
+    /// @brief Next slot to read; written by the consumer. The consumer caches the tail it last saw.
+    alignas(64) std::atomic<size_t> head{0};
+    size_t cachedTail = 0;
+
+    /// @brief Next slot to write; written by the producer. The producer caches the head it last saw.
+    alignas(64) std::atomic<size_t> tail{0};
+    size_t cachedHead = 0;
+};
+
+#endif //GRAPHICS_SPSCRING_H
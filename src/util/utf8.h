@@ -0,0 +1,53 @@
+#ifndef GRAPHICS_UTF8_H
+#define GRAPHICS_UTF8_H
+
+#include <cstddef>
+#include <string_view>
+
+/// @brief Codepoint returned for malformed UTF-8
+const char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+/// @brief Decodes the UTF-8 character at position and moves position past it
+/// @details Malformed sequences (stray continuation bytes, truncated or overlong sequences, surrogates and values
+///          beyond U+10FFFF) decode to REPLACEMENT_CHARACTER and consume a single byte, so decoding always makes
+///          progress and resynchronizes on the next valid lead byte.
+/// @param text The text being decoded
+/// @param position Byte offset of the character to decode, must be less than text.size()
+inline char32_t decodeUtf8(std::string_view text, size_t& position) {
+    unsigned char lead = static_cast<unsigned char>(text[position]);
+    if (lead < 0x80) {
+        position++;
+        return lead;
+    }
+
+    size_t length;
+    char32_t codepoint, minimum;
+    if ((lead & 0xE0) == 0xC0)      { length = 2; codepoint = lead & 0x1F; minimum = 0x80; }
+    else if ((lead & 0xF0) == 0xE0) { length = 3; codepoint = lead & 0x0F; minimum = 0x800; }
+    else if ((lead & 0xF8) == 0xF0) { length = 4; codepoint = lead & 0x07; minimum = 0x10000; }
+    else {
+        position++;
+        return REPLACEMENT_CHARACTER;
+    }
+
+    if (position + length > text.size()) {
+        position++;
+        return REPLACEMENT_CHARACTER;
+    }
+    for (size_t i = 1; i < length; i++) {
+        unsigned char next = static_cast<unsigned char>(text[position + i]);
+        if ((next & 0xC0) != 0x80) {
+            position++;
+            return REPLACEMENT_CHARACTER;
+        }
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+    if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+        position++;
+        return REPLACEMENT_CHARACTER;
+    }
+    position += length;
+    return codepoint;
+}
+
+#endif //GRAPHICS_UTF8_H
@@ -0,0 +1,224 @@
+#include "../src/game/arrowKernels.h"
+#include "../src/game/lane.h"
+#include "../src/jobs/jobSystem.h"
+#include "../src/render/particlePool.h"
+#include "../src/shapes/shape.h"
+#include "../src/sim/botSimulator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+using std::unique_ptr, std::make_unique;
+
+// Measures the game's hot paths outside the game, one benchmark per argument:
+//   jobs     the simulator and particle updates on 1, 2, 4, ... up to every core
+//   kernels  every arrow kernel the CPU supports on 1k, 10k and 100k arrows
+//   shapes   overlap tests of mixed shapes through virtual and inline bounds
+
+/// @brief The bounding box getters as they were before Shape inlined them: pure virtual, overridden per shape type.
+/// @details Only kept for the shapes benchmark to compare against.
+class VirtualBoundsShape {
+public:
+    VirtualBoundsShape(vec2 pos, vec2 size) : pos(pos), size(size) {}
+    virtual ~VirtualBoundsShape() = default;
+    virtual float getLeft() const = 0;
+    virtual float getRight() const = 0;
+    virtual float getTop() const = 0;
+    virtual float getBottom() const = 0;
+
+protected:
+    vec2 pos, size;
+};
+
+class VirtualBoundsRect : public VirtualBoundsShape {
+public:
+    using VirtualBoundsShape::VirtualBoundsShape;
+    float getLeft() const override   { return pos.x - (size.x / 2); }
+    float getRight() const override  { return pos.x + (size.x / 2); }
+    float getTop() const override    { return pos.y + (size.y / 2); }
+    float getBottom() const override { return pos.y - (size.y / 2); }
+};
+
+class VirtualBoundsTriangle : public VirtualBoundsShape {
+public:
+    using VirtualBoundsShape::VirtualBoundsShape;
+    float getLeft() const override   { return pos.x - (size.x / 2); }
+    float getRight() const override  { return pos.x + (size.x / 2); }
+    float getTop() const override    { return pos.y + (size.y / 2); }
+    float getBottom() const override { return pos.y - (size.y / 2); }
+};
+
+class VirtualBoundsArrow : public VirtualBoundsShape {
+public:
+    using VirtualBoundsShape::VirtualBoundsShape;
+    float getLeft() const override   { return pos.x - (size.x / 2); }
+    float getRight() const override  { return pos.x + (size.x / 2); }
+    float getTop() const override    { return pos.y + (size.y / 2); }
+    float getBottom() const override { return pos.y - (size.y / 2); }
+};
+
+/// Shapes in each collection of the shapes benchmark, and how many times each collection is tested.
+const size_t BENCHMARK_SHAPES = 10000;
+const int BENCHMARK_SHAPE_PASSES = 2000;
+
+/// @brief Counts the shapes whose bounding box overlaps the box from (left, bottom) to (right, top).
+template <typename ShapeType>
+static size_t countOverlapping(const vector<unique_ptr<ShapeType>>& shapes, float left, float bottom, float right,
+                               float top) {
+    size_t overlapping = 0;
+    for (const auto& shape : shapes) {
+        if (shape->getLeft() < right && shape->getRight() > left && shape->getBottom() < top &&
+            shape->getTop() > bottom)
+            overlapping++;
+    }
+    return overlapping;
+}
+
+/// @brief Tests a mixed collection of rects, triangles and arrows for overlap through the former virtual bounding
+///        box getters and through Shape's inline ones, and prints the time per shape of each.
+/// @details Drawing is not compared, it needs a GL context and costs a draw call per shape either way.
+static void benchmarkShapes() {
+    Shader shader;
+    vector<unique_ptr<VirtualBoundsShape>> virtualShapes;
+    vector<unique_ptr<Shape>> shapes;
+    uint32_t random = 1;
+    for (size_t i = 0; i < BENCHMARK_SHAPES; i++) {
+        // shape types in random order, so the virtual calls cannot be predicted from the position in the collection
+        random = random * 1664525u + 1013904223u;
+        vec2 pos(static_cast<float>(random >> 8 & 1023), static_cast<float>(random >> 18 & 1023));
+        vec2 size(static_cast<float>(8 + (random & 63)), static_cast<float>(8 + (random >> 6 & 63)));
+        switch ((random >> 28) % 3) {
+            case 0:  virtualShapes.push_back(make_unique<VirtualBoundsRect>(pos, size)); break;
+            case 1:  virtualShapes.push_back(make_unique<VirtualBoundsTriangle>(pos, size)); break;
+            default: virtualShapes.push_back(make_unique<VirtualBoundsArrow>(pos, size)); break;
+        }
+        shapes.push_back(make_unique<Shape>(shader, pos, size, WHITE));
+    }
+
+    double baseNs = 0;
+    for (bool inlined : {false, true}) {
+        size_t overlapping = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < BENCHMARK_SHAPE_PASSES; pass++) {
+            float x = static_cast<float>(pass % 1024), y = static_cast<float>(pass * 7 % 1024);
+            overlapping += inlined ? countOverlapping(shapes, x, y, x + 64, y + 64)
+                                   : countOverlapping(virtualShapes, x, y, x + 64, y + 64);
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                    / (static_cast<double>(BENCHMARK_SHAPES) * BENCHMARK_SHAPE_PASSES);
+        if (!inlined)
+            baseNs = ns;
+        printf("SHAPES: %-7s bounds: %zu shapes %6.3f ns per shape (%.2fx), %zu overlaps\n",
+               inlined ? "inline" : "virtual", BENCHMARK_SHAPES, ns, baseNs / ns, overlapping);
+    }
+}
+
+/// Arrows the kernels benchmark checks per kernel and field size, spread over as many checks as the size needs.
+const size_t BENCHMARK_ARROW_CHECKS = 200000000;
+
+/// @brief Times checkArrows() with every kernel the CPU supports on 1k, 10k and 100k arrows and prints ns per arrow.
+static void benchmarkKernels() {
+    ArrowKernel original = getArrowKernel();
+    ArrowCheckParams params{};
+    for (int l = 0; l < LANE_COUNT; l++)
+        params.hitLow[l] = 150.0f;
+
+    for (size_t arrows : {size_t(1000), size_t(10000), size_t(100000)}) {
+        // arrows spread over the whole lane, some already below the hit window or the screen
+        ArrowField field(arrows);
+        for (size_t i = 0; i < arrows; i++)
+            field.spawn(static_cast<float>(100 + (i % LANE_COUNT) * 200), static_cast<float>(i % 900) - 150.0f,
+                        static_cast<uint8_t>(i % LANE_COUNT), 0.0f);
+        field.moveTo(-2.0);
+        vector<uint8_t> flags(arrows);
+        size_t checks = BENCHMARK_ARROW_CHECKS / arrows;
+
+        double scalarNs = 0;
+        for (ArrowKernel kernel : {ArrowKernel::SCALAR, ArrowKernel::SSE2, ArrowKernel::AVX2}) {
+            if (!setArrowKernel(kernel)) {
+                printf("KERNELS: %-6s %6zu arrows: not supported by this CPU\n", getArrowKernelName(kernel), arrows);
+                continue;
+            }
+            size_t flagged = checkArrows(field, params, flags.data());
+            auto start = std::chrono::steady_clock::now();
+            for (size_t check = 0; check < checks; check++)
+                flagged += checkArrows(field, params, flags.data());
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                        / static_cast<double>(checks * arrows);
+
+            if (kernel == ArrowKernel::SCALAR)
+                scalarNs = ns;
+            printf("KERNELS: %-6s %6zu arrows: %6.3f ns per arrow (%.2fx), %zu flagged per check\n",
+                   getArrowKernelName(kernel), arrows, ns, scalarNs / ns, flagged / (checks + 1));
+        }
+    }
+    setArrowKernel(original);
+}
+
+/// Particles each round of the jobs benchmark moves, and how often.
+const size_t BENCHMARK_PARTICLES = 1 << 20;
+const int BENCHMARK_PARTICLE_UPDATES = 100;
+
+/// @brief Runs the same simulator and particle workloads with 1, 2, 4, ... up to every core and prints the speedups.
+static void benchmarkJobs(SimulatorConfig simulator) {
+    simulator.sessions = 64;
+    simulator.maxSeconds = 30;
+    simulator.engine.seed = simulator.engine.seed == 0 ? 1 : simulator.engine.seed;
+
+    ParticlePool pool(BENCHMARK_PARTICLES);
+    for (size_t i = 0; i < BENCHMARK_PARTICLES; i++)
+        pool.emit(static_cast<float>(i % 800), static_cast<float>(i % 600), 10.0f, 50.0f, 1e9f, 0xFFFFFFFFu);
+    vector<ParticleInstance> instances(BENCHMARK_PARTICLES);
+
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    double simulateBase = 0, particleBase = 0;
+    for (unsigned threads = 1;; threads = std::min(threads * 2, cores)) {
+        simulator.threads = threads;
+        BotSimulator bots(simulator);
+        bots.run();
+        double simulateMs = bots.getWallSeconds() * 1000.0;
+
+        JobSystem jobs(threads);
+        auto start = std::chrono::steady_clock::now();
+        for (int update = 0; update < BENCHMARK_PARTICLE_UPDATES; update++) {
+            jobs.parallelFor(pool.size(), 16384, [&](size_t begin, size_t end) {
+                pool.integrate(begin, end, 0.001f, -900.0f, 1.5f);
+                pool.writeInstances(instances.data(), 4.0f, begin, end);
+            });
+        }
+        double particleMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                            / BENCHMARK_PARTICLE_UPDATES;
+
+        if (threads == 1) {
+            simulateBase = simulateMs;
+            particleBase = particleMs;
+        }
+        printf("JOBS: %2u threads: %u sessions %8.1f ms (%.2fx), %zu particles %6.2f ms per update (%.2fx), %llu steals\n",
+               threads, simulator.sessions, simulateMs, simulateBase / simulateMs, pool.size(), particleMs,
+               particleBase / particleMs, static_cast<unsigned long long>(jobs.getSteals()));
+        if (threads == cores)
+            break;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 2 && !strcmp(argv[1], "jobs")) {
+        benchmarkJobs(SimulatorConfig());
+        return 0;
+    }
+    if (argc == 2 && !strcmp(argv[1], "kernels")) {
+        benchmarkKernels();
+        return 0;
+    }
+    if (argc == 2 && !strcmp(argv[1], "shapes")) {
+        benchmarkShapes();
+        return 0;
+    }
+    std::cout << "Usage: benchmark <jobs|kernels|shapes>" << std::endl;
+    return 1;
+}
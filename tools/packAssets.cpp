@@ -0,0 +1,57 @@
+#include "../src/assets/assetArchive.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+/// @brief Packs every file below a directory into an asset archive, or lists and checks an archive.
+/// Usage:
+///   packAssets <directory> <archive>   pack directory (e.g. res) into archive
+///   packAssets --list <archive>        print the assets of an archive and check their hashes
+int main(int argc, char *argv[]) {
+    if (argc == 3 && !strcmp(argv[1], "--list")) {
+        AssetArchive archive;
+        if (!archive.open(argv[2]))
+            return 1;
+        for (const string& name : archive.getNames()) {
+            AssetView view;
+            if (archive.find(name, view))
+                std::cout << name << " (" << view.size << " bytes)" << std::endl;
+        }
+        return archive.verifyAll() ? 0 : 1;
+    }
+    if (argc != 3) {
+        std::cout << "Usage: packAssets <directory> <archive> | packAssets --list <archive>" << std::endl;
+        return 1;
+    }
+
+    fs::path root = argv[1];
+    std::error_code error;
+    vector<fs::path> files;
+    for (fs::recursive_directory_iterator it(root, error), end; !error && it != end; it.increment(error)) {
+        if (it->is_regular_file())
+            files.push_back(it->path());
+    }
+    if (error) {
+        std::cout << "ERROR::ASSETS: Could not read " << root.string() << ": " << error.message() << std::endl;
+        return 1;
+    }
+    // a stable order makes the archive reproducible
+    std::sort(files.begin(), files.end());
+
+    AssetArchiveWriter writer;
+    if (!writer.open(argv[2]))
+        return 1;
+    for (const fs::path& file : files) {
+        if (!writer.addFile(file.lexically_relative(root).generic_string(), file.string()))
+            return 1;
+    }
+    if (!writer.finish())
+        return 1;
+    std::cout << "ASSETS: Packed " << files.size() << " files from " << root.string() << " into " << argv[2]
+              << std::endl;
+    return 0;
+}